@@ -4,3 +4,9 @@ if (CMAKE_VERSION VERSION_LESS "3.1")
 else()
   set(CMAKE_CXX_STANDARD 11)
 endif()
+
+# debug log messages are compiled out of release builds
+# use -DXBS_DEBUG_LOG=ON to keep them
+if ((CMAKE_BUILD_TYPE STREQUAL "Release") AND NOT XBS_DEBUG_LOG)
+  add_definitions(-DXBS_NO_DEBUG_LOG)
+endif()
@@ -5,6 +5,7 @@
 #include "Platform.h"
 #include "CommandArgs.h"
 #include "Logger.h"
+#include "Pipe.h"
 #include "Screen.h"
 #include "Server.h"
 #include <csignal>
@@ -16,6 +17,12 @@ void termSizeChanged(int) {
   Screen::get(true);
 }
 
+//-----------------------------------------------------------------------------
+void shutdownSignal(int sigNumber) {
+  Server::requestShutdown();
+  Pipe::notifyAll(sigNumber); // wake the server if it's waiting for input
+}
+
 //-----------------------------------------------------------------------------
 int main(const int argc, const char* argv[]) {
   try {
@@ -23,13 +30,26 @@ int main(const int argc, const char* argv[]) {
     CommandArgs::initialize(argc, argv);
     Server server;
 
-    signal(SIGWINCH, termSizeChanged);
     signal(SIGPIPE, SIG_IGN);
 
     if (!server.init()) {
       return 1;
     }
 
+    if (server.isHeadless()) {
+      // keep hosting games after a failed one until asked to shut down
+      signal(SIGINT, shutdownSignal);
+      signal(SIGTERM, shutdownSignal);
+      while (!Server::isShutdownRequested()) {
+        if (!server.run() && !Server::isShutdownRequested()) {
+          Logger::error() << "Game failed, starting a new game";
+        }
+      }
+      Logger::info() << "Shutdown requested, exiting";
+      return 0;
+    }
+
+    signal(SIGWINCH, termSizeChanged);
     while (server.run() && server.isRepeatOn()) { }
     return 0;
   }
@@ -0,0 +1,33 @@
+//-----------------------------------------------------------------------------
+// TournamentMain.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "Platform.h"
+#include "CommandArgs.h"
+#include "Tournament.h"
+#include <iostream>
+
+using namespace xbs;
+
+//-----------------------------------------------------------------------------
+int main(const int argc, const char* argv[]) {
+  try {
+    initRandom();
+    CommandArgs::initialize(argc, argv);
+    Tournament tournament;
+
+    if (!tournament.init()) {
+      return 1;
+    }
+
+    tournament.run();
+    return 0;
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+  }
+  catch (...) {
+    std::cerr << "Unhandles exception" << std::endl;
+  }
+  return 1;
+}
@@ -0,0 +1,31 @@
+//-----------------------------------------------------------------------------
+// TraceMain.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "Platform.h"
+#include "CommandArgs.h"
+#include "TraceReport.h"
+#include <iostream>
+
+using namespace xbs;
+
+//-----------------------------------------------------------------------------
+int main(const int argc, const char* argv[]) {
+  try {
+    CommandArgs::initialize(argc, argv);
+    TraceReport report;
+
+    if (!report.init()) {
+      return 1;
+    }
+
+    return report.run() ? 0 : 1;
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+  }
+  catch (...) {
+    std::cerr << "Unhandles exception" << std::endl;
+  }
+  return 1;
+}
@@ -3,6 +3,7 @@
 // Copyright (c) 2016-2017 Shawn Chidester, All rights reserved
 //-----------------------------------------------------------------------------
 #include "Edgar.h"
+#include "BotPlugin.h"
 #include "CommandArgs.h"
 #include "Logger.h"
 #include <cmath>
@@ -10,9 +11,9 @@
 namespace xbs {
 
 //-----------------------------------------------------------------------------
-void Edgar::frenzyScore(const Board& board,
-                        Coordinate& coord,
-                        const double weight)
+double Edgar::frenzyScore(const Board& board,
+                          const Coordinate& coord,
+                          const double weight)
 {
   // if 1 shot left it's guaranteed to be adjacent to an existing hit
   double w = weight;
@@ -28,7 +29,7 @@ void Edgar::frenzyScore(const Board& board,
   }
 
   double score = 0;
-  unsigned len = board.maxInlineHits(coord);
+  unsigned len = maxInlineHits(board, coord);
   if (len > 1) {
     // inline with 2 or more sequential hits
     score = (2 + (longShip - std::min(longShip, len)));
@@ -62,12 +63,10 @@ void Edgar::frenzyScore(const Board& board,
       switch (!np + !sp + !ep + !wp) {
       case 0:
         // adjacent to 4 perpendicular lines (center of a closed box)
-        searchScore(board, coord, (w * 1.4));
-        return;
+        return searchScore(board, coord, (w * 1.4));
       case 1:
         // adjacent to 3 perpendicular lines
-        searchScore(board, coord, (w * 1.5));
-        return;
+        return searchScore(board, coord, (w * 1.5));
       case 2:
         if (np && sp) {
           assert(!(ep | wp));
@@ -77,8 +76,7 @@ void Edgar::frenzyScore(const Board& board,
           d = (board.getSquare((coord + South) + West) == Ship::HIT);
           if (a & b & c & d) {
             // between parallel horizontal lines
-            searchScore(board, coord, (w * 1.3));
-            return;
+            return searchScore(board, coord, (w * 1.3));
           } else {
             // possible elbow pattern
             score = 1.5;
@@ -91,8 +89,7 @@ void Edgar::frenzyScore(const Board& board,
           d = (board.getSquare((coord + South) + West) == Ship::HIT);
           if (a & b & c & d) {
             // between parallel vertical lines
-            searchScore(board, coord, (w * 1.3));
-            return;
+            return searchScore(board, coord, (w * 1.3));
           } else {
             // possible elbow pattern
             score = 1.5;
@@ -125,37 +122,41 @@ void Edgar::frenzyScore(const Board& board,
         }
         if (a & b) {
           // probably side of a boat
-          searchScore(board, coord, (w * 1.1));
+          return searchScore(board, coord, (w * 1.1));
         } else {
           // adjacent to end of a perpendicular line (possible elbow pattern)
           assert(a | b);
-          searchScore(board, coord, (w * 1.8));
+          return searchScore(board, coord, (w * 1.8));
         }
-        return;
       default:
         assert(false);
       }
     }
   }
 
-  coord.setScore(score * weight);
+  return (score * weight);
 }
 
 //-----------------------------------------------------------------------------
-void Edgar::searchScore(const Board& board,
-                        Coordinate& coord,
-                        const double weight)
+double Edgar::searchScore(const Board& board,
+                          const Coordinate& coord,
+                          const double weight)
 {
-  const double north = board.freeCount(coord, Direction::North);
-  const double south = board.freeCount(coord, Direction::South);
-  const double east  = board.freeCount(coord, Direction::East);
-  const double west  = board.freeCount(coord, Direction::West);
+  const double north = freeCount(board, coord, Direction::North);
+  const double south = freeCount(board, coord, Direction::South);
+  const double east  = freeCount(board, coord, Direction::East);
+  const double west  = freeCount(board, coord, Direction::West);
   const double score = ((north + south + east + west) / (4 * maxLen));
-  coord.setScore(floor(score * weight));
+  return floor(score * weight);
 }
 
 } // namespace xbs
 
+#ifdef XBS_PLUGIN
+//-----------------------------------------------------------------------------
+XBS_BOT_PLUGIN(xbs::Edgar)
+
+#else
 //-----------------------------------------------------------------------------
 int main(const int argc, const char* argv[]) {
   try {
@@ -171,3 +172,5 @@ int main(const int argc, const char* argv[]) {
   }
   return 0;
 }
+
+#endif // XBS_PLUGIN
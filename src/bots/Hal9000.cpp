@@ -3,6 +3,7 @@
 // Copyright (c) 2016-2017 Shawn Chidester, All rights reserved
 //-----------------------------------------------------------------------------
 #include "Hal9000.h"
+#include "BotPlugin.h"
 #include "CommandArgs.h"
 #include "Logger.h"
 #include <cmath>
@@ -10,24 +11,29 @@
 namespace xbs {
 
 //-----------------------------------------------------------------------------
-void Hal9000::frenzyScore(const Board& board,
-                          Coordinate& coord,
-                          const double weight)
+double Hal9000::frenzyScore(const Board& board,
+                            const Coordinate& coord,
+                            const double weight)
 {
-  const unsigned len = board.maxInlineHits(coord);
-  coord.setScore(floor(std::min<unsigned>(longShip, len) * weight));
+  const unsigned len = maxInlineHits(board, coord);
+  return floor(std::min<unsigned>(longShip, len) * weight);
 }
 
 //-----------------------------------------------------------------------------
-void Hal9000::searchScore(const Board&,
-                          Coordinate& coord,
-                          const double weight)
+double Hal9000::searchScore(const Board&,
+                            const Coordinate& coord,
+                            const double weight)
 {
-  coord.setScore(floor(weight / 2));
+  return floor(weight / 2);
 }
 
 } // namespace xbs
 
+#ifdef XBS_PLUGIN
+//-----------------------------------------------------------------------------
+XBS_BOT_PLUGIN(xbs::Hal9000)
+
+#else
 //-----------------------------------------------------------------------------
 int main(const int argc, const char* argv[]) {
   try {
@@ -43,3 +49,5 @@ int main(const int argc, const char* argv[]) {
   }
   return 0;
 }
+
+#endif // XBS_PLUGIN
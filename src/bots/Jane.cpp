@@ -3,6 +3,7 @@
 // Copyright (c) 2016-2017 Shawn Chidester, All rights reserved
 //-----------------------------------------------------------------------------
 #include "Jane.h"
+#include "BotPlugin.h"
 #include "CommandArgs.h"
 #include "Logger.h"
 #include <cmath>
@@ -39,34 +40,33 @@ void Jane::playerJoined(const std::string& player) {
 }
 
 //-----------------------------------------------------------------------------
-Coordinate Jane::bestShotOn(const Board& board) {
+Coordinate Jane::bestShotOn(const Board& board, double& score) {
   legalPlacementSearch(board); // update legal placement map
-  return Bot::bestShotOn(board);
+  return Bot::bestShotOn(board, score);
 }
 
 //-----------------------------------------------------------------------------
-void Jane::frenzyScore(const Board& board,
-                       Coordinate& coord,
-                       const double weight)
+double Jane::frenzyScore(const Board& board,
+                         const Coordinate& coord,
+                         const double weight)
 {
   const unsigned i = board.getShipIndex(coord);
-  const unsigned len = board.maxInlineHits(coord);
-  const double score = (std::min<unsigned>(longShip, len) * weight * legal[i]);
-  coord.setScore(score);
+  const unsigned len = maxInlineHits(board, coord);
+  return (std::min<unsigned>(longShip, len) * weight * legal[i]);
 }
 
 //-----------------------------------------------------------------------------
-void Jane::searchScore(const Board& board,
-                       Coordinate& coord,
-                       const double weight)
+double Jane::searchScore(const Board& board,
+                         const Coordinate& coord,
+                         const double weight)
 {
   const unsigned i = board.getShipIndex(coord);
   double score = ((weight * legal[i]) / 2);
   if (score > 0) {
-    const double n = board.freeCount(coord, Direction::North);
-    const double s = board.freeCount(coord, Direction::South);
-    const double e = board.freeCount(coord, Direction::East);
-    const double w = board.freeCount(coord, Direction::West);
+    const double n = freeCount(board, coord, Direction::North);
+    const double s = freeCount(board, coord, Direction::South);
+    const double e = freeCount(board, coord, Direction::East);
+    const double w = freeCount(board, coord, Direction::West);
     ASSERT(n < maxLen);
     ASSERT(s < maxLen);
     ASSERT(e < maxLen);
@@ -76,7 +76,7 @@ void Jane::searchScore(const Board& board,
       score /= 4;
     }
   }
-  coord.setScore(score);
+  return score;
 }
 
 //-----------------------------------------------------------------------------
@@ -232,8 +232,7 @@ void Jane::getPlacements(const unsigned ply,
 
         unsigned weight = (shipStack.size() - n + 1);
         unsigned len = std::min<unsigned>(hits, (ship.getLength() - 1));
-        double score = ((100 * len * weight) + weight);
-        p.coord.setScore(score);
+        p.score = ((100 * len * weight) + weight);
         placements.push_back(p);
       }
     }
@@ -346,6 +345,11 @@ void Jane::logLegalMap(const Board& board) const {
 
 } // namespace xbs
 
+#ifdef XBS_PLUGIN
+//-----------------------------------------------------------------------------
+XBS_BOT_PLUGIN(xbs::Jane)
+
+#else
 //-----------------------------------------------------------------------------
 int main(const int argc, const char* argv[]) {
   try {
@@ -361,3 +365,5 @@ int main(const int argc, const char* argv[]) {
   }
   return 0;
 }
+
+#endif // XBS_PLUGIN
@@ -37,9 +37,9 @@ public: // Bot implementation
 
 //-----------------------------------------------------------------------------
 protected: // Bot implementation
-  Coordinate bestShotOn(const Board&) override;
-  void frenzyScore(const Board&, Coordinate&, const double) override;
-  void searchScore(const Board&, Coordinate&, const double) override;
+  Coordinate bestShotOn(const Board&, double& score) override;
+  double frenzyScore(const Board&, const Coordinate&, const double) override;
+  double searchScore(const Board&, const Coordinate&, const double) override;
 
 //-----------------------------------------------------------------------------
 private: // structs
@@ -47,11 +47,12 @@ private: // structs
     Coordinate coord;
     Direction dir;
     unsigned shipIndex;
+    unsigned score;
     std::string key(const Ship& ship) const {
       return (coord.toString() + ship.getID() + toStr(dir));
     }
     bool operator<(const Placement& p) const noexcept {
-      return (coord.getScore() > p.coord.getScore());
+      return (score > p.score);
     }
   };
 
@@ -3,6 +3,7 @@
 // Copyright (c) 2016-2017 Shawn Chidester, All rights reserved
 //-----------------------------------------------------------------------------
 #include "RandomRufus.h"
+#include "BotPlugin.h"
 #include "CommandArgs.h"
 #include "Logger.h"
 #include <cmath>
@@ -11,13 +12,18 @@ namespace xbs
 {
 
 //-----------------------------------------------------------------------------
-Coordinate RandomRufus::bestShotOn(const Board&) {
-  const double weight = floor(100 * std::log(remain + 1));
-  return getRandomCoord().setScore(weight);
+Coordinate RandomRufus::bestShotOn(const Board&, double& score) {
+  score = floor(100 * std::log(remain + 1));
+  return getRandomCoord();
 }
 
 } // namespace xbs
 
+#ifdef XBS_PLUGIN
+//-----------------------------------------------------------------------------
+XBS_BOT_PLUGIN(xbs::RandomRufus)
+
+#else
 //-----------------------------------------------------------------------------
 int main(const int argc, const char* argv[]) {
   try {
@@ -34,3 +40,4 @@ int main(const int argc, const char* argv[]) {
   return 0;
 }
 
+#endif // XBS_PLUGIN
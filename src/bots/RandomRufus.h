@@ -19,7 +19,7 @@ public: // constructors
 
 //-----------------------------------------------------------------------------
 protected: // Bot implementation
-  Coordinate bestShotOn(const Board&) override;
+  Coordinate bestShotOn(const Board&, double& score) override;
 };
 
 } // namespace xbs
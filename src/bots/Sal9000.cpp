@@ -3,6 +3,7 @@
 // Copyright (c) 2016-2017 Shawn Chidester, All rights reserved
 //-----------------------------------------------------------------------------
 #include "Sal9000.h"
+#include "BotPlugin.h"
 #include "CommandArgs.h"
 #include "Logger.h"
 #include <cmath>
@@ -10,29 +11,34 @@
 namespace xbs {
 
 //-----------------------------------------------------------------------------
-void Sal9000::frenzyScore(const Board& board,
-                          Coordinate& coord,
-                          const double weight)
+double Sal9000::frenzyScore(const Board& board,
+                            const Coordinate& coord,
+                            const double weight)
 {
-  const unsigned len = board.maxInlineHits(coord);
-  coord.setScore(floor(std::min<unsigned>(longShip, len) * weight));
+  const unsigned len = maxInlineHits(board, coord);
+  return floor(std::min<unsigned>(longShip, len) * weight);
 }
 
 //-----------------------------------------------------------------------------
-void Sal9000::searchScore(const Board& board,
-                          Coordinate& coord,
-                          const double weight)
+double Sal9000::searchScore(const Board& board,
+                            const Coordinate& coord,
+                            const double weight)
 {
-  const double north = board.freeCount(coord, Direction::North);
-  const double south = board.freeCount(coord, Direction::South);
-  const double east  = board.freeCount(coord, Direction::East);
-  const double west  = board.freeCount(coord, Direction::West);
+  const double north = freeCount(board, coord, Direction::North);
+  const double south = freeCount(board, coord, Direction::South);
+  const double east  = freeCount(board, coord, Direction::East);
+  const double west  = freeCount(board, coord, Direction::West);
   const double score = ((north + south + east + west) / (4 * maxLen));
-  coord.setScore(floor(score * weight));
+  return floor(score * weight);
 }
 
 } // namespace xbs
 
+#ifdef XBS_PLUGIN
+//-----------------------------------------------------------------------------
+XBS_BOT_PLUGIN(xbs::Sal9000)
+
+#else
 //-----------------------------------------------------------------------------
 int main(const int argc, const char* argv[]) {
   try {
@@ -48,3 +54,5 @@ int main(const int argc, const char* argv[]) {
   }
   return 0;
 }
+
+#endif // XBS_PLUGIN
@@ -3,9 +3,15 @@
 // Copyright (c) 2016-2017 Shawn Chidester, All rights reserved
 //-----------------------------------------------------------------------------
 #include "Skipper.h"
+#include "BotPlugin.h"
 #include "CommandArgs.h"
 #include "Logger.h"
 
+#ifdef XBS_PLUGIN
+//-----------------------------------------------------------------------------
+XBS_BOT_PLUGIN(xbs::Skipper)
+
+#else
 //-----------------------------------------------------------------------------
 int main(const int argc, const char* argv[]) {
   try {
@@ -22,3 +28,4 @@ int main(const int argc, const char* argv[]) {
   return 0;
 }
 
+#endif // XBS_PLUGIN
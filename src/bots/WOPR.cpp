@@ -3,6 +3,7 @@
 // Copyright (c) 2016-2017 Shawn Chidester, All rights reserved
 //-----------------------------------------------------------------------------
 #include "WOPR.h"
+#include "BotPlugin.h"
 #include "CommandArgs.h"
 #include "Logger.h"
 #include <cmath>
@@ -39,20 +40,17 @@ void WOPR::playerJoined(const std::string& player) {
 }
 
 //-----------------------------------------------------------------------------
-Coordinate WOPR::bestShotOn(const Board& board) {
+Coordinate WOPR::bestShotOn(const Board& board, double& score) {
   legalPlacementSearch(board); // update legal placement map
-  return Bot::bestShotOn(board);
+  return Bot::bestShotOn(board, score);
 }
 
 //-----------------------------------------------------------------------------
-static inline double getSpace(const Board& board,
-                              const Coordinate& coord,
-                              const unsigned maxLen)
-{
-  const double n = board.freeCount(coord, Direction::North);
-  const double s = board.freeCount(coord, Direction::South);
-  const double e = board.freeCount(coord, Direction::East);
-  const double w = board.freeCount(coord, Direction::West);
+double WOPR::getSpace(const Board& board, const Coordinate& coord) const {
+  const double n = freeCount(board, coord, Direction::North);
+  const double s = freeCount(board, coord, Direction::South);
+  const double e = freeCount(board, coord, Direction::East);
+  const double w = freeCount(board, coord, Direction::West);
   ASSERT(n < maxLen);
   ASSERT(s < maxLen);
   ASSERT(e < maxLen);
@@ -61,18 +59,18 @@ static inline double getSpace(const Board& board,
 }
 
 //-----------------------------------------------------------------------------
-void WOPR::frenzyScore(const Board& board,
-                       Coordinate& coord,
-                       const double weight)
+double WOPR::frenzyScore(const Board& board,
+                         const Coordinate& coord,
+                         const double weight)
 {
-  unsigned i = board.getShipIndex(coord);
+  const unsigned i = board.getShipIndex(coord);
   double score = (weight * legal[i]);
   if (score > 0) {
-    const unsigned len = board.maxInlineHits(coord);
+    const unsigned len = maxInlineHits(board, coord);
     if (len > 1) {
       score *= 10;
     } else {
-      const double space = getSpace(board, coord, maxLen);
+      const double space = getSpace(board, coord);
       if (space) {
         score *= space;
       }
@@ -82,18 +80,16 @@ void WOPR::frenzyScore(const Board& board,
       }
     }
   }
-  coord.setScore(score);
+  return score;
 }
 
 //-----------------------------------------------------------------------------
-void WOPR::searchScore(const Board& board,
-                       Coordinate& coord,
-                       const double weight)
+double WOPR::searchScore(const Board& board,
+                         const Coordinate& coord,
+                         const double weight)
 {
-  frenzyScore(board, coord, weight);
-  if (coord.parity() != parity) {
-    coord.setScore(coord.getScore() / 4);
-  }
+  const double score = frenzyScore(board, coord, weight);
+  return (coord.parity() != parity) ? (score / 4) : score;
 }
 
 //-----------------------------------------------------------------------------
@@ -249,8 +245,7 @@ void WOPR::getPlacements(const unsigned ply,
 
         unsigned weight = (shipStack.size() - n + 1);
         unsigned len = std::min<unsigned>(hits, (ship.getLength() - 1));
-        double score = ((100 * len * weight) + weight);
-        p.coord.setScore(score);
+        p.score = ((100 * len * weight) + weight);
         placements.push_back(p);
       }
     }
@@ -363,6 +358,11 @@ void WOPR::logLegalMap(const Board& board) const {
 
 } // namespace xbs
 
+#ifdef XBS_PLUGIN
+//-----------------------------------------------------------------------------
+XBS_BOT_PLUGIN(xbs::WOPR)
+
+#else
 //-----------------------------------------------------------------------------
 int main(const int argc, const char* argv[]) {
   try {
@@ -378,3 +378,5 @@ int main(const int argc, const char* argv[]) {
   }
   return 0;
 }
+
+#endif // XBS_PLUGIN
@@ -38,9 +38,9 @@ public: // Bot implementation
 
 //-----------------------------------------------------------------------------
 protected: // Bot implementation
-  Coordinate bestShotOn(const Board&) override;
-  void frenzyScore(const Board&, Coordinate&, const double) override;
-  void searchScore(const Board&, Coordinate&, const double) override;
+  Coordinate bestShotOn(const Board&, double& score) override;
+  double frenzyScore(const Board&, const Coordinate&, const double) override;
+  double searchScore(const Board&, const Coordinate&, const double) override;
 
 //-----------------------------------------------------------------------------
 private: // structs
@@ -48,16 +48,18 @@ private: // structs
     Coordinate coord;
     Direction dir;
     unsigned shipIndex;
+    unsigned score;
     std::string key(const Ship& ship) const {
       return (coord.toString() + ship.getID() + toStr(dir));
     }
     bool operator<(const Placement& p) const noexcept {
-      return (coord.getScore() > p.coord.getScore());
+      return (score > p.score);
     }
   };
 
 //-----------------------------------------------------------------------------
 private: // methods
+  double getSpace(const Board&, const Coordinate&) const;
   void getPlacements(const unsigned ply, const std::string& desc, const Board&,
                      std::vector<Placement>&) const;
   const Ship& popShip(const unsigned idx);
@@ -58,6 +58,11 @@ Board& Board::stealConnectionFrom(Board&& other) {
   return (*this);
 }
 
+//-----------------------------------------------------------------------------
+TcpSocket Board::releaseConnection() noexcept {
+  return std::move(socket);
+}
+
 //-----------------------------------------------------------------------------
 Board& Board::addHitTaunt(const std::string& value) {
   hitTaunts.push_back(value);
@@ -100,6 +105,24 @@ Board& Board::incTurns(const unsigned value) noexcept {
   return (*this);
 }
 
+//-----------------------------------------------------------------------------
+Board& Board::setDeltaUpdates(const bool value) noexcept {
+  deltaUpdates = value;
+  return (*this);
+}
+
+//-----------------------------------------------------------------------------
+Board& Board::setKeepAlive(const bool value) noexcept {
+  keepAlive = value;
+  return (*this);
+}
+
+//-----------------------------------------------------------------------------
+Board& Board::setLocal(const bool value) noexcept {
+  local = value;
+  return (*this);
+}
+
 //-----------------------------------------------------------------------------
 Board& Board::setName(const std::string& value) {
   socket.setLabel(value);
@@ -195,6 +218,29 @@ std::vector<Coordinate> Board::shipAreaCoordinates() const {
   return std::move(coords);
 }
 
+//-----------------------------------------------------------------------------
+bool Board::canAddHitOrMiss(const unsigned i, const char value)
+const noexcept {
+  if (i >= descriptor.size()) {
+    return false;
+  } else if (value == Ship::HIT) {
+    return (Ship::isValidID(descriptor[i]) || (descriptor[i] == Ship::HIT));
+  } else if (value == Ship::MISS) {
+    return ((descriptor[i] == Ship::NONE) || (descriptor[i] == Ship::MISS));
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Board::addHitOrMiss(const unsigned i, const char value) noexcept {
+  if (!canAddHitOrMiss(i, value)) {
+    return false;
+  } else if ((value == Ship::HIT) || (value == Ship::MISS)) {
+    descriptor[i] = value;
+  }
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 bool Board::addHitsAndMisses(const std::string& desc) noexcept {
   if (desc.empty() || !isValid() || (desc.size() != descriptor.size())) {
@@ -202,19 +248,7 @@ bool Board::addHitsAndMisses(const std::string& desc) noexcept {
   }
   bool ok = true;
   for (unsigned i = 0; i < desc.size(); ++i) {
-    if (desc[i] == Ship::HIT) {
-      if (Ship::isValidID(descriptor[i])) {
-        descriptor[i] = Ship::HIT;
-      } else if (descriptor[i] != Ship::HIT) {
-        ok = false;
-      }
-    } else if (desc[i] == Ship::MISS) {
-      if (descriptor[i] == Ship::NONE) {
-        descriptor[i] = desc[i];
-      } else if (descriptor[i] != Ship::MISS) {
-        ok = false;
-      }
-    }
+    ok &= addHitOrMiss(i, desc[i]);
   }
   return ok;
 }
@@ -263,7 +297,7 @@ bool Board::addShip(const Ship& ship, Coordinate coord, const Direction dir) {
 
 //-----------------------------------------------------------------------------
 bool Board::isDead() const noexcept {
-  return (!socket || (hitCount() >= shipPointCount()));
+  return ((!socket && !local) || (hitCount() >= shipPointCount()));
 }
 
 //-----------------------------------------------------------------------------
@@ -288,49 +322,74 @@ bool Board::print(const bool masked, const Configuration* config) const {
     return false;
   }
 
+  Screen& screen = Screen::get();
   Coordinate rowHead(getTopLeft());
-
-  // player name (row 1)
-  if (toMove) {
-    Screen::print() << rowHead << ' ' << Red << '*' << DefaultColor;
-  } else {
-    Screen::print() << rowHead << "  ";
-  }
-  Screen::print() << ' ' << socket.getLabel();
+  const unsigned bottom = (rowHead.getY() + 1 + shipArea.getHeight());
+  const bool samePlace = (rowHead == printedAt);
+  const bool full = (!samePlace || (masked != printedMasked) ||
+                     (printedSquares.size() != descriptor.size()) ||
+                     (screen.getClearStamp(rowHead.getY(), bottom) !=
+                      printStamp));
+
+  // player name (row 1), always printed, it's short and changes often
+  std::string info = (' ' + socket.getLabel());
   if (status.size()) {
-    Screen::print() << " (" << status << ')';
+    info += (" (" + status + ')');
   } else if (config) {
-    Screen::print() << " (" << score;
+    info += (" (" + toStr(score));
     if (skips) {
-      Screen::print() << ", " << skips;
+      info += (", " + toStr(skips));
     }
     unsigned points = config->getPointGoal();
     if (points) {
-      Screen::print() << ", " << ((100 * hitCount()) / points) << '%';
+      info += (", " + toStr((100 * hitCount()) / points) + '%');
     }
-    Screen::print() << ')';
+    info += ')';
   }
 
-  // X coordinate header (row 2)
-  Screen::print() << rowHead.south() << "  ";
-  for (unsigned x = 0; x < shipArea.getWidth(); ++x) {
-    Screen::print() << ' ' << static_cast<char>('a' + x);
+  if (toMove) {
+    screen << rowHead << ' ' << Red << '*' << DefaultColor << info;
+  } else {
+    screen << rowHead << "  " << info;
+  }
+  if (samePlace && (info.size() < printedInfoLen)) {
+    screen << std::string((printedInfoLen - info.size()), ' ');
+  }
+  printedInfoLen = info.size();
+
+  if (full) {
+    // X coordinate header (row 2)
+    screen << rowHead.south() << "  ";
+    for (unsigned x = 0; x < shipArea.getWidth(); ++x) {
+      screen << ' ' << static_cast<char>('a' + x);
+    }
   }
 
   // ship area (rows 3+)
+  const unsigned width = shipArea.getWidth();
+  printedSquares.resize(descriptor.size());
   for (unsigned i = 0; i < descriptor.size(); ++i) {
-    if (!(i % shipArea.getWidth())) {
-      Screen::print() << rowHead.south() << rPad(getShipCoord(i).getY(), 2);
-    }
-    if (masked) {
-      Screen::print() << ' ' << Ship::mask(descriptor[i]);
-    } else {
-      Screen::print() << ' ' << descriptor[i];
+    const char ch = (masked ? Ship::mask(descriptor[i]) : descriptor[i]);
+    if (full) {
+      if (!(i % width)) {
+        screen << rowHead.south() << rPad(getShipCoord(i).getY(), 2);
+      }
+      screen << ' ' << ch;
+    } else if (ch != printedSquares[i]) {
+      screen << Coordinate((getTopLeft().getX() + 3 + (2 * (i % width))),
+                           (getTopLeft().getY() + 2 + (i / width)))
+             << ch;
     }
+    printedSquares[i] = ch;
   }
 
+  printedAt = getTopLeft();
+  printedMasked = masked;
+  printStamp = screen.getClearStamp(printedAt.getY(), bottom);
+
   // move cursor to status row
-  Screen::print() << rowHead.south();
+  screen << Coordinate(printedAt.getX(),
+                       (printedAt.getY() + 2 + shipArea.getHeight()));
   return true;
 }
 
@@ -355,6 +414,31 @@ bool Board::updateDescriptor(const std::string& desc) {
   return true;
 }
 
+//-----------------------------------------------------------------------------
+bool Board::canUpdateSquares(const SquareUpdates& squares) const noexcept {
+  for (const auto& square : squares) {
+    if ((square.first >= descriptor.size()) ||
+        ((square.second != Ship::NONE) &&
+         (square.second != Ship::MISS) &&
+         (square.second != Ship::HIT)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Board::updateSquares(const SquareUpdates& squares) noexcept {
+  if (!canUpdateSquares(squares)) {
+    return false;
+  }
+  for (const auto& square : squares) {
+    descriptor[square.first] = square.second;
+  }
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 char Board::getSquare(const unsigned i) const noexcept {
   return (i < descriptor.size()) ? descriptor[i] : 0;
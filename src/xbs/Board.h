@@ -44,6 +44,12 @@ namespace xbs
 //                    |...0X.| (row3)
 //                    +------+
 // Example ship area descriptor: .X..X.0X0..0...0X. (row1row2row3)
+//-----------------------------------------------------------------------------
+// List of (ship area index, masked square value) pairs used to send and
+// apply board changes without transferring the entire board descriptor
+//-----------------------------------------------------------------------------
+typedef std::vector<std::pair<unsigned, char>> SquareUpdates;
+
 //-----------------------------------------------------------------------------
 class Board : public Rectangle {
 //-----------------------------------------------------------------------------
@@ -52,6 +58,10 @@ private: // variables
   unsigned score = 0;
   unsigned skips = 0;
   unsigned turns = 0;
+  unsigned updates = 0;
+  bool deltaUpdates = false;
+  bool keepAlive = false;
+  bool local = false; // played in-process, never has a connection
   Rectangle shipArea;
   TcpSocket socket;
   std::string descriptor;
@@ -59,6 +69,13 @@ private: // variables
   std::vector<std::string> hitTaunts;
   std::vector<std::string> missTaunts;
 
+  // what the last print() put on the screen
+  mutable bool printedMasked = false;
+  mutable unsigned printedInfoLen = 0;
+  mutable u_int64_t printStamp = 0;
+  mutable Coordinate printedAt;
+  mutable std::string printedSquares;
+
 //-----------------------------------------------------------------------------
 public: // constructors
   Board() = default;
@@ -98,14 +115,20 @@ public: // methods
   std::vector<std::string> getMissTaunts() const { return missTaunts; }
   bool hasHitTaunts() const noexcept { return !hitTaunts.empty(); }
   bool hasMissTaunts() const noexcept { return !missTaunts.empty(); }
+  bool isBinary() const noexcept { return socket.isBinary(); }
   bool isConnected() const noexcept { return socket.isOpen(); }
+  bool isLocal() const noexcept { return local; }
   bool isToMove() const noexcept { return toMove; }
+  bool wantsDeltaUpdates() const noexcept { return deltaUpdates; }
+  bool wantsKeepAlive() const noexcept { return keepAlive; }
   bool send(const std::string& msg) const { return socket.send(msg); }
   int handle() const noexcept { return socket.getHandle(); }
   unsigned getScore() const noexcept { return score; }
   unsigned getSkips() const noexcept { return skips; }
   unsigned getTurns() const noexcept { return turns; }
+  unsigned incUpdates() noexcept { return ++updates; }
   void disconnect() noexcept { socket.close(); }
+  void setBinary(const bool flag) noexcept { socket.setBinary(flag); }
 
   Board& addHitTaunt(const std::string&);
   Board& addMissTaunt(const std::string&);
@@ -114,6 +137,9 @@ public: // methods
   Board& incScore(const unsigned = 1) noexcept;
   Board& incSkips(const unsigned = 1) noexcept;
   Board& incTurns(const unsigned = 1) noexcept;
+  Board& setDeltaUpdates(const bool) noexcept;
+  Board& setKeepAlive(const bool) noexcept;
+  Board& setLocal(const bool) noexcept;
   Board& setName(const std::string&);
   Board& setScore(const unsigned) noexcept;
   Board& setSkips(const unsigned) noexcept;
@@ -121,6 +147,7 @@ public: // methods
   Board& setToMove(const bool) noexcept;
   Board& setTurns(const unsigned) noexcept;
   Board& stealConnectionFrom(Board&&);
+  TcpSocket releaseConnection() noexcept;
 
   std::string maskedDescriptor() const;
   std::string nextHitTaunt() const;
@@ -128,6 +155,8 @@ public: // methods
   std::string summary(const unsigned boardNum, const bool gameStarted) const;
   std::vector<Coordinate> shipAreaCoordinates() const;
 
+  bool canAddHitOrMiss(const unsigned idx, const char value) const noexcept;
+  bool addHitOrMiss(const unsigned idx, const char value) noexcept;
   bool addHitsAndMisses(const std::string& descriptor) noexcept;
   bool addRandomShips(const Configuration&, const double minSurfaceArea);
   bool addShip(const Ship&, Coordinate, const Direction);
@@ -135,9 +164,27 @@ public: // methods
   bool matchesConfig(const Configuration&) const;
   bool onEdge(const unsigned idx) const noexcept;
   bool onEdge(const Coordinate&) const noexcept;
+
+  /**
+   * @brief Print this board at its screen position.  If the board was
+   *        printed before at the same position and none of its rows have
+   *        been cleared since then only the squares that changed are drawn
+   * @param masked Show the squares as seen by the other players
+   * @param config Show score, skips, and percent of point goal if not null
+   * @return false if the board is not valid
+   */
   bool print(const bool masked, const Configuration* = nullptr) const;
+
+  /**
+   * @brief Make the next print() draw the entire board, use this after
+   *        drawing something else over the board without clearing it
+   */
+  void invalidatePrint() const noexcept { printedSquares.clear(); }
+
   bool removeShip(const Ship&) noexcept;
   bool updateDescriptor(const std::string& newDescriptor);
+  bool canUpdateSquares(const SquareUpdates&) const noexcept;
+  bool updateSquares(const SquareUpdates&) noexcept;
 
   char getSquare(const unsigned idx) const noexcept;
   char getSquare(const Coordinate&) const noexcept;
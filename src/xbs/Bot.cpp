@@ -25,7 +25,7 @@ Bot::Bot(const std::string& name, const Version& version)
 //-----------------------------------------------------------------------------
 std::string Bot::newGame(const Configuration& config) {
   if (debugMode) {
-    Logger::debug() << "New game with '" << config.getName() << "' config";
+    XBS_LOG_DEBUG() << "New game with '" << config.getName() << "' config";
   }
 
   parity = random(2);
@@ -59,7 +59,7 @@ std::string Bot::newGame(const Configuration& config) {
 //-----------------------------------------------------------------------------
 void Bot::playerJoined(const std::string& player) {
   if (debugMode) {
-    Logger::debug() << "Player joined: '" << player << "'";
+    XBS_LOG_DEBUG() << "Player joined: '" << player << "'";
   }
 
   game.addBoard(std::make_shared<Board>(player, getGameConfig()));
@@ -68,7 +68,7 @@ void Bot::playerJoined(const std::string& player) {
 //-----------------------------------------------------------------------------
 void Bot::startGame(const std::vector<std::string>& playerOrder) {
   if (debugMode) {
-    Logger::debug() << "Starting game '" << game.getTitle() << "'";
+    XBS_LOG_DEBUG() << "Starting game '" << game.getTitle() << "'";
   }
 
   game.setBoardOrder(playerOrder);
@@ -83,7 +83,7 @@ void Bot::finishGame(const std::string& state,
                      const unsigned playerCount)
 {
   if (debugMode) {
-    Logger::debug() << "Game '" << game.getTitle()
+    XBS_LOG_DEBUG() << "Game '" << game.getTitle()
                     << "' finished, state: " << state
                     << ", turns: " << turnCount
                     << ", players: " << playerCount;
@@ -99,7 +99,7 @@ void Bot::playerResult(const std::string& player,
                        const unsigned turns,
                        const std::string& status)
 {
-  Logger::debug() << "Player '" << player
+  XBS_LOG_DEBUG() << "Player '" << player
                   << "' score: " << score
                   << ", skips: " << skips
                   << ", turns: " << turns
@@ -115,7 +115,7 @@ void Bot::updateBoard(const std::string& player,
                       const unsigned turns)
 {
   if (debugMode) {
-    Logger::debug() << "updateBoard(player=" << player
+    XBS_LOG_DEBUG() << "updateBoard(player=" << player
                     << ", status=" << status
                     << ", score=" << score
                     << ", skips=" << skips
@@ -144,12 +144,45 @@ void Bot::updateBoard(const std::string& player,
   }
 }
 
+//-----------------------------------------------------------------------------
+void Bot::updateSquares(const std::string& player,
+                        const std::string& status,
+                        const SquareUpdates& squares,
+                        const unsigned score,
+                        const unsigned skips)
+{
+  if (debugMode) {
+    XBS_LOG_DEBUG() << "updateSquares(player=" << player
+                    << ", status=" << status
+                    << ", score=" << score
+                    << ", skips=" << skips
+                    << ", squares=" << squares.size() << ')';
+  }
+
+  auto board = game.boardForPlayer(player, true);
+  if (!board) {
+    throw Error(Msg() << "Unknonwn player name: '" << player << "'");
+  }
+  if (!board->updateSquares(squares)) {
+    throw Error(Msg() << "Failed to update '" << player << "' board squares");
+  }
+  if (player == getPlayerName()) {
+    for (const auto& square : squares) {
+      if (!myBoard->addHitOrMiss(square.first, square.second)) {
+        throw Error(Msg() << "Failed to update '" << player
+                    << "' hits/misses");
+      }
+    }
+  }
+  board->setStatus(status).setScore(score).setSkips(skips);
+}
+
 //-----------------------------------------------------------------------------
 void Bot::skipPlayerTurn(const std::string& player,
                          const std::string& reason)
 {
   if (debugMode) {
-    Logger::debug() << "skipPlayerTurn(player=" << player
+    XBS_LOG_DEBUG() << "skipPlayerTurn(player=" << player
                     << ", reasaon=" << reason << ')';
   }
 }
@@ -157,7 +190,7 @@ void Bot::skipPlayerTurn(const std::string& player,
 //-----------------------------------------------------------------------------
 void Bot::updatePlayerToMove(const std::string& player) {
   if (debugMode) {
-    Logger::debug() << "updatePlayerToMove(" << player << ')';
+    XBS_LOG_DEBUG() << "updatePlayerToMove(" << player << ')';
   }
 }
 
@@ -167,7 +200,7 @@ void Bot::messageFrom(const std::string& from,
                       const std::string& group)
 {
   if (debugMode) {
-    Logger::debug() << "messageFrom(from=" << from
+    XBS_LOG_DEBUG() << "messageFrom(from=" << from
                     << ", group=" << group
                     << ", msg=" << msg << ')';
   }
@@ -179,7 +212,7 @@ void Bot::hitScored(const std::string& player,
                        const Coordinate& hitCoordinate)
 {
   if (debugMode) {
-    Logger::debug() << "hitScored(player=" << player
+    XBS_LOG_DEBUG() << "hitScored(player=" << player
                     << ", target=" << target
                     << ", coord=" << hitCoordinate << ')';
   }
@@ -196,13 +229,16 @@ std::string Bot::getBestShot(Coordinate& shotCoord) {
 
   Board* bestBoard = nullptr;
   Coordinate bestCoord;
+  double bestScore = 0;
 
   std::random_shuffle(boards.begin(), boards.end());
   for (auto& board : boards) {
-    Coordinate coord(getTargetCoordinate(*board));
-    if (coord && (!bestBoard || (coord.getScore() > bestCoord.getScore()))) {
+    double score = 0;
+    const Coordinate coord(getTargetCoordinate(*board, score));
+    if (coord && (!bestBoard || (score > bestScore))) {
       bestBoard = board;
       bestCoord = coord;
+      bestScore = score;
     }
   }
 
@@ -211,29 +247,34 @@ std::string Bot::getBestShot(Coordinate& shotCoord) {
 }
 
 //-----------------------------------------------------------------------------
-Coordinate Bot::getTargetCoordinate(const Board& board) {
-  const std::string desc = board.getDescriptor();
-  if (desc.empty() || (desc.size() != boardSize)) {
-    throw std::runtime_error("Incorrect board descriptor size");
-  }
+static unsigned squareCount(const Board& board) noexcept {
+  return board.getShipArea().getSize();
+}
 
-  coords.clear();
-  adjacentHits.assign(boardSize, 0);
-  adjacentFree.assign(boardSize, 0);
-  frenzySquares.clear();
-  splatCount = 0;
-  hitCount = 0;
+//-----------------------------------------------------------------------------
+template<unsigned W, unsigned H>
+static constexpr unsigned squareCount(const FixedBoard<W, H>&) noexcept {
+  return (W * H);
+}
 
-  for (unsigned i = 0; i < boardSize; ++i) {
-    const Coordinate coord(board.getShipCoord(i));
-    adjacentHits[i] = board.adjacentHits(coord);
-    adjacentFree[i] = board.adjacentFree(coord);
+//-----------------------------------------------------------------------------
+template<typename BoardType>
+void Bot::scanSquares(const BoardType& squares,
+                      const Board& board,
+                      const std::string& desc)
+{
+  for (unsigned i = 0; i < squareCount(squares); ++i) {
+    adjacentHits[i] = squares.adjacentHits(i);
+    adjacentFree[i] = squares.adjacentFree(i);
     if (desc[i] == Ship::NONE) {
       if (adjacentHits[i]) {
         frenzySquares.insert(i);
-        coords.push_back(coord);
-      } else if (adjacentFree[i] && (coord.parity() == parity)) {
-        coords.push_back(coord);
+        coords.push_back(board.getShipCoord(i));
+      } else if (adjacentFree[i]) {
+        const Coordinate coord(board.getShipCoord(i));
+        if (coord.parity() == parity) {
+          coords.push_back(coord);
+        }
       }
     } else {
       splatCount++;
@@ -242,6 +283,32 @@ Coordinate Bot::getTargetCoordinate(const Board& board) {
       }
     }
   }
+}
+
+//-----------------------------------------------------------------------------
+Coordinate Bot::getTargetCoordinate(const Board& board, double& score) {
+  const std::string desc = board.getDescriptor();
+  if (desc.empty() || (desc.size() != boardSize)) {
+    throw std::runtime_error("Incorrect board descriptor size");
+  }
+
+  coords.clear();
+  frenzySquares.clear();
+  splatCount = 0;
+  hitCount = 0;
+
+  struct SnapshotGuard {
+    const Board*& source;
+    ~SnapshotGuard() { source = nullptr; }
+  } guard{standardSource};
+
+  if (StandardBoard::matches(board.getShipArea())) {
+    standardSource = &board;
+    standardBoard.load(desc);
+    scanSquares(standardBoard, board, desc);
+  } else {
+    scanSquares(board, board, desc);
+  }
 
   ASSERT(shipTotal >= hitCount);
   remain = (shipTotal - hitCount);
@@ -253,58 +320,86 @@ Coordinate Bot::getTargetCoordinate(const Board& board) {
   }
 
   if (!remain) {
-    return getRandomCoord().setScore(0);
+    score = 0;
+    return getRandomCoord();
   }
 
-  return bestShotOn(board);
+  return bestShotOn(board, score);
 }
 
 //-----------------------------------------------------------------------------
-Coordinate Bot::bestShotOn(const Board& board) {
+Coordinate Bot::bestShotOn(const Board& board, double& score) {
   const double weight = (100 * std::log(remain + 1));
 
-  for (Coordinate& coord : coords) {
+  scores.resize(coords.size());
+  for (unsigned n = 0; n < coords.size(); ++n) {
+    const Coordinate& coord = coords[n];
     const unsigned i = board.getShipIndex(coord);
     if (adjacentHits[i]) {
-      frenzyScore(board, coord, weight);
+      scores[n] = frenzyScore(board, coord, weight);
     } else {
-      searchScore(board, coord, weight);
+      scores[n] = searchScore(board, coord, weight);
     }
   }
 
-  return getBestCoord();
+  return getBestCoord(score);
 
-//  Coordinate best(getBestCoord());
+//  Coordinate best(getBestCoord(score));
 //  optionsWeight = std::log((splatCount / coords.size()) + 1);
-//  best.setScore(floor(best.getScore() * (1 + optionsWeight)));
-//  return std::move(best);
+//  score = floor(score * (1 + optionsWeight));
+//  return best;
 }
 
 //-----------------------------------------------------------------------------
-void Bot::frenzyScore(const Board&, Coordinate&, const double) {
+double Bot::frenzyScore(const Board&, const Coordinate&, const double) {
+  return 0;
 }
 
 //-----------------------------------------------------------------------------
-void Bot::searchScore(const Board&, Coordinate&, const double) {
+double Bot::searchScore(const Board&, const Coordinate&, const double) {
+  return 0;
 }
 
 //-----------------------------------------------------------------------------
-Coordinate& Bot::getBestCoord() {
+Coordinate Bot::getBestCoord(double& score) {
   ASSERT(coords.size());
-  std::random_shuffle(coords.begin(), coords.end());
+  ASSERT(scores.size() == coords.size());
   unsigned best = 0;
+  unsigned ties = 1;
   for (unsigned i = 1; i < coords.size(); ++i) {
-    if (coords[i].getScore() > coords[best].getScore()) {
+    if (scores[i] > scores[best]) {
       best = i;
+      ties = 1;
+    } else if ((scores[i] == scores[best]) && !random(++ties)) {
+      best = i; // pick uniformly among equal scores
     }
   }
+  score = scores[best];
   return coords[best];
 }
 
 //-----------------------------------------------------------------------------
-Coordinate& Bot::getRandomCoord() {
+Coordinate Bot::getRandomCoord() {
   ASSERT(coords.size());
   return coords[random(coords.size())];
 }
 
+//-----------------------------------------------------------------------------
+unsigned Bot::freeCount(const Board& board,
+                        const Coordinate& coord,
+                        const Direction dir) const
+{
+  return (&board == standardSource)
+      ? standardBoard.freeCount(board.getShipIndex(coord), dir)
+      : board.freeCount(coord, dir);
+}
+
+//-----------------------------------------------------------------------------
+unsigned Bot::maxInlineHits(const Board& board, const Coordinate& coord) const
+{
+  return (&board == standardSource)
+      ? standardBoard.maxInlineHits(board.getShipIndex(coord))
+      : board.maxInlineHits(coord);
+}
+
 } // namespace xbs
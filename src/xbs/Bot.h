@@ -9,6 +9,7 @@
 #include "Board.h"
 #include "Configuration.h"
 #include "Coordinate.h"
+#include "FixedBoard.h"
 #include "Game.h"
 #include "Version.h"
 
@@ -38,12 +39,19 @@ protected: // variables
   unsigned hitCount = 0;
   unsigned remain = 0;
   std::vector<Coordinate> coords;
+  std::vector<double> scores; // parallel to coords
   std::vector<unsigned> adjacentHits;
   std::vector<unsigned> adjacentFree;
   std::set<unsigned> frenzySquares;
   std::unique_ptr<Board> myBoard;
   Game game;
 
+  // snapshot of the board passed to getTargetCoordinate() when it has the
+  // standard geometry, used by the freeCount() and maxInlineHits() helpers
+  // only for that board and only until getTargetCoordinate() returns
+  const Board* standardSource = nullptr;
+  StandardBoard standardBoard;
+
 //-----------------------------------------------------------------------------
 public: // constructor
   Bot(const std::string& name, const Version& version);
@@ -61,7 +69,7 @@ public: // destructor
 public: // virtual methods
   virtual std::string newGame(const Configuration& gameConfig);
   virtual std::string getBestShot(Coordinate&);
-  virtual Coordinate getTargetCoordinate(const Board&);
+  virtual Coordinate getTargetCoordinate(const Board&, double& score);
   virtual void playerJoined(const std::string& player);
   virtual void startGame(const std::vector<std::string>& playerOrder);
   virtual void finishGame(const std::string& state,
@@ -78,6 +86,11 @@ public: // virtual methods
                            const unsigned score,
                            const unsigned skips,
                            const unsigned turns = ~0U);
+  virtual void updateSquares(const std::string& player,
+                             const std::string& status,
+                             const SquareUpdates& squares,
+                             const unsigned score,
+                             const unsigned skips);
   virtual void skipPlayerTurn(const std::string& player,
                               const std::string& reason);
   virtual void updatePlayerToMove(const std::string& player);
@@ -117,14 +130,22 @@ public: // setters
 
 //-----------------------------------------------------------------------------
 protected: // virtual methods
-  virtual Coordinate bestShotOn(const Board&);
-  virtual void frenzyScore(const Board&, Coordinate&, const double weight);
-  virtual void searchScore(const Board&, Coordinate&, const double weight);
+  virtual Coordinate bestShotOn(const Board&, double& score);
+  virtual double frenzyScore(const Board&, const Coordinate&, const double);
+  virtual double searchScore(const Board&, const Coordinate&, const double);
 
 //-----------------------------------------------------------------------------
 protected: // methods
-  Coordinate& getBestCoord();
-  Coordinate& getRandomCoord();
+  Coordinate getBestCoord(double& score);
+  Coordinate getRandomCoord();
+
+  unsigned freeCount(const Board&, const Coordinate&, const Direction) const;
+  unsigned maxInlineHits(const Board&, const Coordinate&) const;
+
+//-----------------------------------------------------------------------------
+private: // methods
+  template<typename BoardType>
+  void scanSquares(const BoardType&, const Board&, const std::string& desc);
 };
 
 } // namespace xbs
@@ -0,0 +1,338 @@
+//-----------------------------------------------------------------------------
+// BotPlugin.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_BOT_PLUGIN_H
+#define XBS_BOT_PLUGIN_H
+
+#include "Platform.h"
+#include "Bot.h"
+#include "CommandArgs.h"
+#include <mutex>
+#include <type_traits>
+
+//-----------------------------------------------------------------------------
+// C interface to a bot compiled into a shared library.  Only C types cross
+// the library boundary, so host and plugin don't need to agree on the
+// layout of any C++ classes.  A plugin exports one function, named by
+// XBS_BOT_PLUGIN_ENTRY, that returns the table of bot functions.
+//
+// Functions that return int return 0 on success.  On failure the error
+// message is available from lastError().  Strings returned by the plugin
+// remain valid until the next call on the same bot instance.
+//
+// Use the XBS_BOT_PLUGIN macro to export a Bot subclass as a plugin.
+//-----------------------------------------------------------------------------
+#define XBS_BOT_PLUGIN_ABI_VERSION 1
+#define XBS_BOT_PLUGIN_ENTRY "xbs_get_bot_plugin"
+
+extern "C" {
+
+typedef struct xbs_ship {
+  char id;
+  unsigned length;
+} xbs_ship;
+
+typedef struct xbs_config {
+  const char* name;
+  unsigned minPlayers;
+  unsigned maxPlayers;
+  unsigned pointGoal;
+  unsigned boardWidth;
+  unsigned boardHeight;
+  unsigned shipCount;
+  const xbs_ship* ships;
+} xbs_config;
+
+typedef struct xbs_bot_plugin {
+  unsigned abiVersion;
+  void* (*create)(int argc, const char* argv[]);
+  void (*destroy)(void* bot);
+  const char* (*lastError)(void* bot);
+  const char* (*getBotName)(void* bot);
+  const char* (*getBotVersion)(void* bot);
+  const char* (*getPlayerName)(void* bot);
+  int (*setPlayerName)(void* bot, const char* name);
+  int (*setStaticBoard)(void* bot, const char* boardDescriptor);
+  int (*newGame)(void* bot, const xbs_config* config,
+                 const char** boardDescriptor);
+  int (*getBestShot)(void* bot, const char** target,
+                     unsigned* x, unsigned* y);
+  int (*playerJoined)(void* bot, const char* player);
+  int (*startGame)(void* bot, const char* const* playerOrder,
+                   unsigned playerCount);
+  int (*finishGame)(void* bot, const char* state,
+                    unsigned turnCount, unsigned playerCount);
+  int (*playerResult)(void* bot, const char* player, unsigned score,
+                      unsigned skips, unsigned turns, const char* status);
+  int (*updateBoard)(void* bot, const char* player, const char* status,
+                     const char* boardDescriptor, unsigned score,
+                     unsigned skips, unsigned turns);
+  int (*updateSquares)(void* bot, const char* player, const char* status,
+                       const unsigned* indexes, const char* values,
+                       unsigned count, unsigned score, unsigned skips);
+  int (*skipPlayerTurn)(void* bot, const char* player, const char* reason);
+  int (*updatePlayerToMove)(void* bot, const char* player);
+  int (*messageFrom)(void* bot, const char* from, const char* msg,
+                     const char* group);
+  int (*hitScored)(void* bot, const char* player, const char* target,
+                   unsigned x, unsigned y);
+} xbs_bot_plugin;
+
+typedef const xbs_bot_plugin* (*xbs_get_bot_plugin_fn)(void);
+
+} // extern "C"
+
+//-----------------------------------------------------------------------------
+#define XBS_BOT_PLUGIN(BotClass) \
+  extern "C" const xbs_bot_plugin* xbs_get_bot_plugin(void) { \
+    return xbs::BotPluginExport<BotClass>::getPlugin(); \
+  }
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// Adapts the C interface to the Bot virtuals of the given class.  The class
+// must be default constructible, or constructible from the create()
+// arguments as a std::vector<std::string>, library path first.  Exceptions
+// never cross the library boundary, they are stored and reported through
+// lastError().
+//
+// Every instance created from one loaded library shares its CommandArgs,
+// Logger and LogWriter.  The arguments of the first create() initialize
+// CommandArgs, later instances only get their arguments through the bot's
+// constructor.
+//-----------------------------------------------------------------------------
+template<class T>
+class BotPluginExport {
+//-----------------------------------------------------------------------------
+private: // structs
+  struct Instance {
+    T bot;
+    std::string error;
+    std::string result;
+
+    explicit Instance(const std::vector<std::string>& args)
+      : Instance(args,
+                 std::is_constructible<T, const std::vector<std::string>&>())
+    { }
+
+  private:
+    Instance(const std::vector<std::string>& args, std::true_type)
+      : bot(args)
+    { }
+
+    Instance(const std::vector<std::string>&, std::false_type)
+      : bot()
+    { }
+  };
+
+//-----------------------------------------------------------------------------
+public: // static methods
+  static const xbs_bot_plugin* getPlugin() {
+    static const xbs_bot_plugin plugin = {
+      XBS_BOT_PLUGIN_ABI_VERSION,
+      create,
+      destroy,
+      lastError,
+      getBotName,
+      getBotVersion,
+      getPlayerName,
+      setPlayerName,
+      setStaticBoard,
+      newGame,
+      getBestShot,
+      playerJoined,
+      startGame,
+      finishGame,
+      playerResult,
+      updateBoard,
+      updateSquares,
+      skipPlayerTurn,
+      updatePlayerToMove,
+      messageFrom,
+      hitScored
+    };
+    return &plugin;
+  }
+
+//-----------------------------------------------------------------------------
+private: // static methods
+  template<typename Func>
+  static int call(void* ptr, Func func) {
+    Instance& instance = (*static_cast<Instance*>(ptr));
+    try {
+      func(instance);
+      instance.error.clear();
+      return 0;
+    } catch (const std::exception& e) {
+      instance.error = e.what();
+    } catch (...) {
+      instance.error = "unhandled exception";
+    }
+    return -1;
+  }
+
+  static void* create(int argc, const char* argv[]) {
+    try {
+      // once per loaded library, references handed out by getInstance()
+      // must stay valid while other instances are created
+      static std::once_flag initialized;
+      std::call_once(initialized, [&]() {
+        if (argc > 0) {
+          CommandArgs::initialize(argc, argv);
+        }
+        initRandom();
+      });
+
+      std::vector<std::string> args;
+      for (int i = 0; i < argc; ++i) {
+        args.push_back(argv[i] ? argv[i] : "");
+      }
+      return new Instance(args);
+    } catch (...) {
+      return nullptr;
+    }
+  }
+
+  static void destroy(void* ptr) {
+    delete static_cast<Instance*>(ptr);
+  }
+
+  static const char* lastError(void* ptr) {
+    return static_cast<Instance*>(ptr)->error.c_str();
+  }
+
+  static const char* getBotName(void* ptr) {
+    return static_cast<Instance*>(ptr)->bot.getBotName().c_str();
+  }
+
+  static const char* getBotVersion(void* ptr) {
+    Instance& instance = (*static_cast<Instance*>(ptr));
+    instance.result = instance.bot.getBotVersion().toString();
+    return instance.result.c_str();
+  }
+
+  static const char* getPlayerName(void* ptr) {
+    return static_cast<Instance*>(ptr)->bot.getPlayerName().c_str();
+  }
+
+  static int setPlayerName(void* ptr, const char* name) {
+    return call(ptr, [&](Instance& i) { i.bot.setPlayerName(name); });
+  }
+
+  static int setStaticBoard(void* ptr, const char* desc) {
+    return call(ptr, [&](Instance& i) { i.bot.setStaticBoard(desc); });
+  }
+
+  static int newGame(void* ptr, const xbs_config* cfg, const char** desc) {
+    return call(ptr, [&](Instance& i) {
+      Configuration config;
+      config.setName(cfg->name)
+          .setMinPlayers(cfg->minPlayers)
+          .setMaxPlayers(cfg->maxPlayers)
+          .setPointGoal(cfg->pointGoal)
+          .setBoardSize(cfg->boardWidth, cfg->boardHeight);
+      for (unsigned n = 0; n < cfg->shipCount; ++n) {
+        config.addShip(Ship(cfg->ships[n].id, cfg->ships[n].length));
+      }
+      i.result = i.bot.newGame(config);
+      (*desc) = i.result.c_str();
+    });
+  }
+
+  static int getBestShot(void* ptr, const char** target,
+                         unsigned* x, unsigned* y)
+  {
+    return call(ptr, [&](Instance& i) {
+      Coordinate coord;
+      i.result = i.bot.getBestShot(coord);
+      (*target) = i.result.c_str();
+      (*x) = coord.getX();
+      (*y) = coord.getY();
+    });
+  }
+
+  static int playerJoined(void* ptr, const char* player) {
+    return call(ptr, [&](Instance& i) { i.bot.playerJoined(player); });
+  }
+
+  static int startGame(void* ptr, const char* const* playerOrder,
+                       unsigned playerCount)
+  {
+    return call(ptr, [&](Instance& i) {
+      i.bot.startGame(std::vector<std::string>(playerOrder,
+                                               (playerOrder + playerCount)));
+    });
+  }
+
+  static int finishGame(void* ptr, const char* state,
+                        unsigned turnCount, unsigned playerCount)
+  {
+    return call(ptr, [&](Instance& i) {
+      i.bot.finishGame(state, turnCount, playerCount);
+    });
+  }
+
+  static int playerResult(void* ptr, const char* player, unsigned score,
+                          unsigned skips, unsigned turns, const char* status)
+  {
+    return call(ptr, [&](Instance& i) {
+      i.bot.playerResult(player, score, skips, turns, status);
+    });
+  }
+
+  static int updateBoard(void* ptr, const char* player, const char* status,
+                         const char* desc, unsigned score, unsigned skips,
+                         unsigned turns)
+  {
+    return call(ptr, [&](Instance& i) {
+      i.bot.updateBoard(player, status, desc, score, skips, turns);
+    });
+  }
+
+  static int updateSquares(void* ptr, const char* player, const char* status,
+                           const unsigned* indexes, const char* values,
+                           unsigned count, unsigned score, unsigned skips)
+  {
+    return call(ptr, [&](Instance& i) {
+      SquareUpdates squares;
+      squares.reserve(count);
+      for (unsigned n = 0; n < count; ++n) {
+        squares.push_back(std::make_pair(indexes[n], values[n]));
+      }
+      i.bot.updateSquares(player, status, squares, score, skips);
+    });
+  }
+
+  static int skipPlayerTurn(void* ptr, const char* player,
+                            const char* reason)
+  {
+    return call(ptr, [&](Instance& i) {
+      i.bot.skipPlayerTurn(player, reason);
+    });
+  }
+
+  static int updatePlayerToMove(void* ptr, const char* player) {
+    return call(ptr, [&](Instance& i) { i.bot.updatePlayerToMove(player); });
+  }
+
+  static int messageFrom(void* ptr, const char* from, const char* msg,
+                         const char* group)
+  {
+    return call(ptr, [&](Instance& i) { i.bot.messageFrom(from, msg, group); });
+  }
+
+  static int hitScored(void* ptr, const char* player, const char* target,
+                       unsigned x, unsigned y)
+  {
+    return call(ptr, [&](Instance& i) {
+      i.bot.hitScored(player, target, Coordinate(x, y));
+    });
+  }
+};
+
+} // namespace xbs
+
+#endif // XBS_BOT_PLUGIN_H
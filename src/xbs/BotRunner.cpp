@@ -38,6 +38,7 @@ void BotRunner::help() {
       << "  Bot runs in shell mode if game server host not specified" << EL
       << "  -h, --host <address>      Connect to game server at given address" << EL
       << "  -p, --port <value>        Connect to game server on given port" << EL
+      << "  --binary                  Request binary message framing" << EL
       << EL
       << "BOARD OPTIONS:" << EL
       << "  -s, --static-board <brd>  Use given board instead of random generation" << EL
@@ -65,6 +66,7 @@ BotRunner::BotRunner(const std::string& botName, const Version& botVersion)
   setDebugMode(args.has("--debug"));
   host = args.getStrAfter({"-h", "--host"});
   port = args.getIntAfter({"-p", "--port"}, Server::DEFAULT_PORT);
+  binary = args.has("--binary");
 
   const std::string msa = args.getStrAfter("--msa");
   if (msa.size()) {
@@ -116,6 +118,10 @@ void BotRunner::play() {
         break; // restart waitForGameStart() loop
       } else if (type == "B") {
         handleBoardMessage();
+      } else if (type == "D") {
+        handleBoardUpdateMessage();
+      } else if (type == "P") {
+        continue; // keepalive
       } else if (type == "K") {
         handleSkipTurnMessage();
       } else if (type == "N") {
@@ -156,6 +162,8 @@ bool BotRunner::waitForGameStart() {
       handleBoardMessage();
     } else if (type == "M") {
       handleMessageMessage();
+    } else if (type == "P") {
+      continue; // keepalive
     } else if (type == "S") {
       handleGameStartedMessage();
     } else {
@@ -179,6 +187,29 @@ void BotRunner::handleBoardMessage() {
   updateBoard(player, status, desc, score, skips);
 }
 
+//-----------------------------------------------------------------------------
+void BotRunner::handleBoardUpdateMessage() {
+  const std::string player = input.getStr(1);
+  const std::string status = input.getStr(2);
+  const unsigned score = input.getUInt(3);
+  const unsigned skips = input.getUInt(4);
+  const unsigned count = input.getFieldCount();
+  if (player.empty() || (count < 5) || !(count % 2)) {
+    throw Error(Msg() << "Invalid board update message: " << input.getLine());
+  }
+
+  SquareUpdates squares;
+  for (unsigned i = 5; i < count; i += 2) {
+    const std::string value = input.getStr(i + 1);
+    if (value.size() != 1) {
+      throw Error(Msg() << "Invalid board update message: "
+                  << input.getLine());
+    }
+    squares.push_back(std::make_pair(input.getUInt(i, ~0U), value[0]));
+  }
+  updateSquares(player, status, squares, score, skips);
+}
+
 //-----------------------------------------------------------------------------
 void BotRunner::handleGameFinishedMessage() {
   const std::string state = input.getStr(1);
@@ -218,11 +249,21 @@ void BotRunner::handleGameInfoMessage() {
 
   newGame(config);
 
-  if (gameStarted) {
-    sendln(Msg('J') << getPlayerName());
-  } else {
-    sendln(Msg('J') << getPlayerName() << myBoard->getDescriptor());
+  // join options are only requested when connected to a game server
+  const bool requestBinary = (binary && host.size());
+  CSVWriter joinMsg = Msg('J') << getPlayerName();
+  if (!gameStarted) {
+    joinMsg << myBoard->getDescriptor();
+  } else if (host.size()) {
+    joinMsg << "";
+  }
+  if (host.size()) {
+    joinMsg << Server::DELTA_OPTION << Server::PING_OPTION;
+  }
+  if (requestBinary) {
+    joinMsg << Server::BINARY_OPTION;
   }
+  sendln(joinMsg);
 
   std::string msg = readln(input);
   std::string str = input.getStr();
@@ -232,6 +273,12 @@ void BotRunner::handleGameInfoMessage() {
     if (str != getPlayerName()) {
       throw Error(Msg() << "Unexpected join response: " << msg);
     }
+    for (unsigned i = 2; requestBinary && (i < input.getFieldCount()); ++i) {
+      if (input.getStr(i) == Server::BINARY_OPTION) {
+        sock.setBinary(true);
+        input.setBinary(sock.getHandle(), true);
+      }
+    }
     playerJoined(str);
     if (gameStarted) {
       msg = readln(input);
@@ -357,7 +404,7 @@ void BotRunner::login() {
     sendln(Msg('I') << getBotName() << getBotVersion() << getPlayerName());
   }
 
-  Logger::debug() << "Waiting for game info message";
+  XBS_LOG_DEBUG() << "Waiting for game info message";
   readln(input);
   handleGameInfoMessage();
 }
@@ -21,6 +21,7 @@ class BotRunner : public Bot {
 //-----------------------------------------------------------------------------
 protected: // variables
   int port = 0;
+  bool binary = false;
   std::string host;
   TcpSocket sock;
 
@@ -64,6 +65,7 @@ private: // methods
 
   bool waitForGameStart();
   void handleBoardMessage();
+  void handleBoardUpdateMessage();
   void handleGameFinishedMessage();
   void handleGameInfoMessage();
   void handleGameStartedMessage();
@@ -9,7 +9,7 @@
 #include "Logger.h"
 #include "Msg.h"
 #include "Screen.h"
-#include "db/FileSysDatabase.h"
+#include <thread>
 
 namespace xbs
 {
@@ -53,45 +53,147 @@ BotTester::BotTester() {
 
 //-----------------------------------------------------------------------------
 void BotTester::test(Bot& bot) {
+  test(std::vector<Bot*>(1, &bot));
+}
+
+//-----------------------------------------------------------------------------
+void BotTester::test(const std::vector<Bot*>& bots) {
+  if (bots.empty() || std::count(bots.begin(), bots.end(), nullptr)) {
+    throw Error("No bot to test");
+  }
+
+  Bot& bot = (*bots.front());
   if (!config) {
     throw Error("Invalid test configuration");
   } else if (bot.getPlayerName() == TARGET_BOARD_NAME) {
     throw Error("Please use a different name for the bot your testing");
+  } else if (watch && (bots.size() > 1)) {
+    throw Error("Watch mode can't be used with more than one test worker");
   }
 
   // try to prevent bot from wasting time generating a new board each iteration
-  if (staticBoard.size()) {
-    bot.setStaticBoard(staticBoard);
-  } else {
+  std::string desc = staticBoard;
+  if (desc.empty()) {
     Board tmp("tmp", config);
     if (!tmp.addRandomShips(config, minSurfaceArea)) {
       throw Error("Unable to generate random board for specified config");
     }
-    bot.setStaticBoard(tmp.getDescriptor());
+    desc = tmp.getDescriptor();
+  }
+  for (Bot* worker : bots) {
+    worker->setStaticBoard(desc);
   }
 
   totalShots = 0;
   maxShots = 0;
   minShots = ~0U;
   perfectGames = 0;
+  assigned = 0;
+  tested = 0;
+  stopped = false;
+  lastPosition.clear();
   uniquePositions.clear();
 
-  std::ofstream trainingFile;
   if (trainingOutputFile.size()) {
     trainingFile.open(trainingOutputFile);
   }
 
   std::shared_ptr<DBRecord> rec = newTestRecord(bot);
-  Board targetBoard(bot.getPlayerName(), config);
   Board displayBoard(bot.getPlayerName(), config);
-  Coordinate statusLine = printStart(bot, (*rec), displayBoard);
-  Timer timer;
-  Input input;
+  statusLine = printStart(bot, (*rec), displayBoard);
+  timer.start();
+
+  if (bots.size() == 1) {
+    runWorker(bot, &displayBoard);
+  } else {
+    runWorkers(bots, displayBoard);
+  }
+
+  if (stopped) {
+    return;
+  } else if (!totalShots) {
+    throw Error("No shots taken");
+  }
+
+  const Milliseconds elapsed = timer.elapsed();
+  Screen::print() << displayBoard.getTopLeft() << ClearToScreenEnd;
+  displayBoard.print(true);
+  Screen::print() << statusLine << ClearToScreenEnd << positions
+                  << " positions complete! time = " << timer << EL << Flush;
+
+  const double avg = (double(totalShots) / positions);
+  Screen::print() << "Min shots to sink all boats: " << minShots << EL
+                  << "Max shots to sink all boats: " << maxShots << EL
+                  << "Avg shots to sink all boats: " << avg << EL
+                  << "Perfect games              : " << perfectGames << EL
+                  << "Unique test positions      : "
+                  << uniquePositions.size() << EL
+                  << Flush;
+
+  storeResult((*rec), elapsed);
+  db.sync();
+}
+
+//-----------------------------------------------------------------------------
+void BotTester::runWorkers(const std::vector<Bot*>& bots, Board& displayBoard)
+{
+  std::vector<std::exception_ptr> errors(bots.size());
+  std::vector<std::thread> threads;
+  unsigned running = bots.size();
 
-  for (unsigned tested = 0; tested < positions; ++tested) {
+  for (unsigned i = 0; i < bots.size(); ++i) {
+    threads.push_back(std::thread([this, &bots, &errors, &running, i]() {
+      try {
+        runWorker((*bots[i]), nullptr);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      if (errors[i]) {
+        stopped = true; // tell other workers to stop
+      }
+      running--;
+      workerDone.notify_all();
+    }));
+  }
+
+  // workers don't touch the screen, so show their progress from here
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+      workerDone.wait_for(lock, std::chrono::milliseconds(Timer::ONE_SECOND));
+      if (!stopped && tested && (timer.tock() >= Timer::ONE_SECOND)) {
+        lock.unlock();
+        printProgress(displayBoard);
+        lock.lock();
+      }
+    }
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  if (lastPosition.size() && !displayBoard.updateDescriptor(lastPosition)) {
+    throw Error("Failed to update display board");
+  }
+}
+
+//-----------------------------------------------------------------------------
+void BotTester::runWorker(Bot& bot, Board* displayBoard) {
+  Board targetBoard(bot.getPlayerName(), config);
+  Board workBoard(bot.getPlayerName(), config);
+  Board& shotBoard = (displayBoard ? (*displayBoard) : workBoard);
+
+  while (nextPosition()) {
     newTargetBoard(bot, targetBoard);
-    uniquePositions.insert(targetBoard.getDescriptor());
-    if (!displayBoard.updateDescriptor(targetBoard.maskedDescriptor())) {
+    if (!shotBoard.updateDescriptor(targetBoard.maskedDescriptor())) {
       throw Error("Failed to mask boat area");
     }
 
@@ -109,100 +211,130 @@ void BotTester::test(Bot& bot) {
       const char id = targetBoard.shootSquare(coord);
       if (!id || Ship::isHit(id) || Ship::isMiss(id)) {
         throw Error(Msg() << "Invalid target coord: " << coord);
-      } else if (++totalShots == 0) {
+      } else if (++shots == 0) {
         throw Error("Shot count overflow");
       } else if (Ship::isValidID(id)) {
         if (trainingFile &&
-            (!trainAdjacentHitsOnly || displayBoard.adjacentHits(coord)))
+            (!trainAdjacentHitsOnly || shotBoard.adjacentHits(coord)))
         {
-          unsigned idx = displayBoard.getShipIndex(coord);
-          const std::string desc = targetBoard.getDescriptor();
-          const std::string masked = displayBoard.getDescriptor();
-          trainingFile << masked << ',' << coord << ',' << idx;
-          for (unsigned i = 0; i < desc.size(); ++i) {
-            if ((i != idx) && (masked[i] == Ship::NONE) &&
-                Ship::isShip(desc[i]))
-            {
-              trainingFile << ',' << i;
-            }
-          }
-          trainingFile << std::endl;
+          writeTrainingData(targetBoard, shotBoard, coord);
         }
-        displayBoard.setSquare(coord, Ship::HIT);
+        shotBoard.setSquare(coord, Ship::HIT);
         hits++;
       } else {
-        displayBoard.setSquare(coord, Ship::MISS);
+        shotBoard.setSquare(coord, Ship::MISS);
       }
 
-      Logger::debug() << "best shot = " << coord;
-      bot.updateBoard(player, "", displayBoard.getDescriptor(), 0, 0);
-      shots++;
-
-      if (watch) {
-        displayBoard.print(true);
-        Screen::print() << (statusLine + South) << ClearToScreenEnd
-                        << "(S)top watching, (Q)uit, [RET=continue] -> "
-                        << Flush;
-        if (input.readln(STDIN_FILENO, 0)) {
-          const std::string str = input.getStr();
-          if (iStartsWith(str, 'Q')) {
-            return;
-          } else if (iStartsWith(str, 'S')) {
-            watch = false;
-            Screen::print() << displayBoard.getTopLeft() << ClearToScreenEnd;
-            displayBoard.print(true);
-            Screen::get().flush();
-          }
-        }
+      XBS_LOG_DEBUG() << "best shot = " << coord;
+      bot.updateBoard(player, "", shotBoard.getDescriptor(), 0, 0);
+
+      if (displayBoard && watch && !watchShot(shotBoard)) {
+        stopped = true;
+        return;
       }
     }
 
-    minShots = std::min(shots, minShots);
-    maxShots = std::max(shots, maxShots);
-    perfectGames += (shots == hits);
-
-    if (!tested || (timer.tock() >= Timer::ONE_SECOND)) {
-      timer.tick();
-      double avg = (double(totalShots) / (tested + 1));
-      displayBoard.print(true);
-      Screen::print() << statusLine << ClearToScreenEnd << (tested + 1)
-                      << " positions, time " << timer
-                      << ", min/max/avg shots " << minShots
-                      << '/' << maxShots << '/' << avg << EL << Flush;
+    addResult(targetBoard, shotBoard, shots, hits);
+    if (displayBoard && ((tested == 1) || (timer.tock() >= Timer::ONE_SECOND)))
+    {
+      printProgress(*displayBoard);
     }
   }
+}
 
-  if (!totalShots) {
-    throw Error("No shots taken");
+//-----------------------------------------------------------------------------
+bool BotTester::nextPosition() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (stopped || (assigned >= positions)) {
+    return false;
   }
+  assigned++;
+  return true;
+}
 
-  const Milliseconds elapsed = timer.elapsed();
-  Screen::print() << displayBoard.getTopLeft() << ClearToScreenEnd;
-  displayBoard.print(true);
-  Screen::print() << statusLine << ClearToScreenEnd << positions
-                  << " positions complete! time = " << timer << EL << Flush;
-
-  const double avg = (double(totalShots) / positions);
-  Screen::print() << "Min shots to sink all boats: " << minShots << EL
-                  << "Max shots to sink all boats: " << maxShots << EL
-                  << "Avg shots to sink all boats: " << avg << EL
-                  << "Perfect games              : " << perfectGames << EL
-                  << "Unique test positions      : " << uniquePositions.size() << EL
+//-----------------------------------------------------------------------------
+bool BotTester::watchShot(Board& board) {
+  board.print(true);
+  Screen::print() << (statusLine + South) << ClearToScreenEnd
+                  << "(S)top watching, (Q)uit, [RET=continue] -> "
                   << Flush;
+  if (input.readln(STDIN_FILENO, 0)) {
+    const std::string str = input.getStr();
+    if (iStartsWith(str, 'Q')) {
+      return false;
+    } else if (iStartsWith(str, 'S')) {
+      watch = false;
+      Screen::print() << board.getTopLeft() << ClearToScreenEnd;
+      board.print(true);
+      Screen::get().flush();
+    }
+  }
+  return true;
+}
 
-  storeResult((*rec), elapsed);
+//-----------------------------------------------------------------------------
+void BotTester::addResult(const Board& targetBoard,
+                          const Board& shotBoard,
+                          const unsigned shots,
+                          const unsigned hits)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  uniquePositions.insert(targetBoard.getDescriptor());
+  lastPosition = shotBoard.getDescriptor();
+  totalShots += shots;
+  minShots = std::min(shots, minShots);
+  maxShots = std::max(shots, maxShots);
+  perfectGames += (shots == hits);
+  tested++;
+}
+
+//-----------------------------------------------------------------------------
+void BotTester::printProgress(Board& displayBoard) {
+  std::unique_lock<std::mutex> lock(mutex);
+  const unsigned count = tested;
+  const double avg = (double(totalShots) / std::max(1U, count));
+  const unsigned min = minShots;
+  const unsigned max = maxShots;
+  const std::string desc = lastPosition;
+  lock.unlock();
+
+  timer.tick();
+  if (desc.size() && !displayBoard.updateDescriptor(desc)) {
+    throw Error("Failed to update display board");
+  }
+  displayBoard.print(true);
+  Screen::print() << statusLine << ClearToScreenEnd << count
+                  << " positions, time " << timer
+                  << ", min/max/avg shots " << min
+                  << '/' << max << '/' << avg << EL << Flush;
 }
 
 //-----------------------------------------------------------------------------
-std::shared_ptr<DBRecord> BotTester::newTestRecord(
-    const Bot& bot) const
+void BotTester::writeTrainingData(const Board& targetBoard,
+                                  const Board& shotBoard,
+                                  const Coordinate& coord)
 {
+  const unsigned idx = shotBoard.getShipIndex(coord);
+  const std::string desc = targetBoard.getDescriptor();
+  const std::string masked = shotBoard.getDescriptor();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  trainingFile << masked << ',' << coord << ',' << idx;
+  for (unsigned i = 0; i < desc.size(); ++i) {
+    if ((i != idx) && (masked[i] == Ship::NONE) && Ship::isShip(desc[i])) {
+      trainingFile << ',' << i;
+    }
+  }
+  trainingFile << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<DBRecord> BotTester::newTestRecord(const Bot& bot) {
   std::string recordID = ("test." +
                           toStr(config.getBoardWidth()) + "x" +
                           toStr(config.getBoardHeight()) + "." +
                           bot.getPlayerName() + "-" +
                           bot.getBotVersion().toString());
-  FileSysDatabase db;
   std::shared_ptr<DBRecord> rec = db.open(testDB).get(recordID, true);
   if (!rec) {
     throw Error(Msg() << "Failed to get " << recordID << " from " << db);
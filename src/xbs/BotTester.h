@@ -10,8 +10,12 @@
 #include "Coordinate.h"
 #include "Board.h"
 #include "Bot.h"
+#include "Input.h"
 #include "Timer.h"
-#include "db/DBRecord.h"
+#include "db/FileSysDatabase.h"
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
 
 namespace xbs
 {
@@ -27,12 +31,23 @@ private: // variables
   unsigned minShots = 0;
   unsigned perfectGames = 0;
   unsigned positions = 0;
+  unsigned assigned = 0;
+  unsigned tested = 0;
+  bool stopped = false;
   Configuration config;
+  Coordinate statusLine;
+  Input input;
+  Timer timer;
+  FileSysDatabase db;
   std::set<std::string> uniquePositions;
+  std::string lastPosition;
   std::string staticBoard;
   std::string testDB;
   std::string trainingOutputFile;
+  std::ofstream trainingFile;
   bool trainAdjacentHitsOnly = false;
+  std::mutex mutex;
+  std::condition_variable workerDone;
 
 //-----------------------------------------------------------------------------
 public: // constructors
@@ -42,12 +57,29 @@ public: // constructors
 public: // methods
   void test(Bot&);
 
+  /**
+   * @brief Test multiple instances of the same bot concurrently
+   * Each bot is run on its own thread and gets its own test positions.
+   * Results from all bots are combined into a single test record.
+   * @param bots The bot instances, the first is used to name the test record
+   */
+  void test(const std::vector<Bot*>& bots);
+
 //-----------------------------------------------------------------------------
 private: // methods
-  std::shared_ptr<DBRecord> newTestRecord(const Bot&) const;
+  std::shared_ptr<DBRecord> newTestRecord(const Bot&);
   Coordinate printStart(const Bot&, const DBRecord&, Board&) const;
+  bool nextPosition();
+  bool watchShot(Board&);
+  void addResult(const Board& targetBoard, const Board& shotBoard,
+                 const unsigned shots, const unsigned hits);
   void newTargetBoard(Bot&, Board&) const;
+  void printProgress(Board& displayBoard);
+  void runWorker(Bot&, Board* displayBoard);
+  void runWorkers(const std::vector<Bot*>&, Board& displayBoard);
   void storeResult(DBRecord&, const Milliseconds elapsed) const;
+  void writeTrainingData(const Board& targetBoard, const Board& shotBoard,
+                         const Coordinate&);
 };
 
 } // namespace xbs
@@ -9,8 +9,6 @@
 #include "Printable.h"
 #include "StringUtils.h"
 
-#include <sstream>
-
 namespace xbs
 {
 
@@ -21,15 +19,15 @@ private: // variables
   bool trim = false;
   char delim = ',';
   unsigned cellCount = 0;
-  std::stringstream row;
+  std::string row;
 
 //-----------------------------------------------------------------------------
 public: // constructors
   CSVWriter() = default;
   CSVWriter(CSVWriter&&) noexcept = default;
   CSVWriter& operator=(CSVWriter&&) noexcept = default;
-  CSVWriter(const CSVWriter&);
-  CSVWriter& operator=(const CSVWriter&);
+  CSVWriter(const CSVWriter&) = default;
+  CSVWriter& operator=(const CSVWriter&) = default;
 
   explicit CSVWriter(const char delim, const bool trim = false)
     : trim(trim),
@@ -43,13 +41,13 @@ public: // constructors
   {
     if (str.size()) {
       cellCount++;
-      row << str;
+      row = str;
     }
   }
 
  //-----------------------------------------------------------------------------
 public: // Printable implementation
-  std::string toString() const override { return row.str(); }
+  std::string toString() const override { return row; }
 
 //-----------------------------------------------------------------------------
 public: // getters
@@ -72,11 +70,27 @@ public: // setters
 //-----------------------------------------------------------------------------
 public: // methods
   CSVWriter& clear() {
-    row.str(std::string());
+    row.clear();
     cellCount = 0;
     return (*this);
   }
 
+  CSVWriter& reserve(const unsigned size) {
+    row.reserve(size);
+    return (*this);
+  }
+
+  /**
+   * @brief Move the row out of this writer without copying it
+   * @return The row, this writer is left empty
+   */
+  std::string release() {
+    std::string str;
+    str.swap(row);
+    cellCount = 0;
+    return str;
+  }
+
   CSVWriter& writeCell(const std::string& strCell);
 
   CSVWriter& writeCells(const std::vector<std::string>& strCells) {
@@ -90,7 +104,11 @@ public: // methods
 public: // operator overloads
   template<typename T>
   CSVWriter& operator<<(const T& cellData) {
-    return writeCell(toStr(cellData));
+    if (cellCount++ && delim) {
+      row += delim;
+    }
+    appendStr(row, cellData);
+    return (*this);
   }
 };
 
@@ -5,6 +5,7 @@
 #include "CanonicalMode.h"
 #include "Logger.h"
 #include "Msg.h"
+#include "Screen.h"
 #include "StringUtils.h"
 #include "Error.h"
 
@@ -13,7 +14,8 @@ namespace xbs
 
 //-----------------------------------------------------------------------------
 CanonicalMode::CanonicalMode(const bool enabled)
-  : ok(false)
+  : ok(false),
+    echo(enabled)
 {
   termios ios;
   if (tcgetattr(STDIN_FILENO, &ios) < 0) {
@@ -45,6 +47,13 @@ CanonicalMode::~CanonicalMode() noexcept {
       }
     }
   }
+  if (echo) {
+    try {
+      Screen::get().echoed();
+    } catch (...) {
+      ASSERT(false);
+    }
+  }
 }
 
 } // namespace xbs
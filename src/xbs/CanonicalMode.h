@@ -14,11 +14,15 @@ namespace xbs
 //-----------------------------------------------------------------------------
 // Saves the current statge of the terminal's canonical and echo flags,
 // enables or disables them, and restores saved state when goes out of scope
+//
+// When enabled the Screen is told that input was echoed when this goes out
+// of scope, so the screen rows the echo may have changed are repainted
 //-----------------------------------------------------------------------------
 class CanonicalMode {
 //-----------------------------------------------------------------------------
 private: // variables
   bool ok;
+  bool echo;
   termios savedTermIOs;
 
 //-----------------------------------------------------------------------------
@@ -8,6 +8,7 @@
 #include "CommandArgs.h"
 #include "Logger.h"
 #include "Msg.h"
+#include "PluginBot.h"
 #include "Screen.h"
 #include "Server.h"
 #include "StringUtils.h"
@@ -48,6 +49,7 @@ void Client::showHelp() {
       << "CONNECTION OPTIONS:" << EL
       << "  -h, --host <address>      Connect to game server at given address" << EL
       << "  -p, --port <value>        Connect to game server on given port" << EL
+      << "  --binary                  Request binary message framing" << EL
       << EL
       << "GAME SETUP OPTIONS:" << EL
       << "  -u, --user <name>         Join using given user/player name" << EL
@@ -56,14 +58,18 @@ void Client::showHelp() {
       << EL
       << "BOT OPTIONS:" << EL
       << "  --bot <shell_cmd>         Run the given shell-bot" << EL
+      << "  --bot-timeout <msecs>     Max time to wait for shell-bot shots,"
+      << " default: " << ShellBot::DEFAULT_REPLY_TIMEOUT << EL
+      << "  --plugin <lib> [args]     Load bot from given shared library" << EL
       << EL
       << "BOT TESTING OPTIONS:" << EL
-      << "  --test                    Test bot and exit (requires --bot)" << EL
+      << "  --test                    Test bot and exit (requires a bot)" << EL
       << "  -c, --count <value>       Set position count for --test mode" << EL
       << "  -x, --width <value>       Set board width for --test mode" << EL
       << "  -y, --height <value>      Set board height for --test mode" << EL
       << "  -d, --test-db <dir>       Set database dir for --test mode" << EL
       << "  -w, --watch               Watch every shot during --test mode" << EL
+      << "  -j, --workers <count>     Run bots in parallel for --test" << EL
       << EL << Flush;
 }
 
@@ -103,19 +109,27 @@ bool Client::init() {
 
   staticBoard = args.getStrAfter({"-s", "--static-board"});
   botCommand = args.getStrAfter("--bot");
+  botTimeout = args.getUIntAfter("--bot-timeout",
+                                 ShellBot::DEFAULT_REPLY_TIMEOUT);
   test = (args.has("--test"));
+  binary = (args.has("--binary"));
 
-  if (test && isEmpty(botCommand)) {
+  botPlugin = args.getStrAfter("--plugin");
+
+  if (botCommand.size() && botPlugin.size()) {
     showHelp();
-    Logger::printError() << "--test option requires --bot option";
+    Logger::printError() << "--bot and --plugin options are exclusive";
     return false;
   }
 
-  if (!isEmpty(botCommand)) {
-    bot.reset(new ShellBot(botCommand));
-    bot->setStaticBoard(staticBoard);
+  if (test && isEmpty(botCommand) && isEmpty(botPlugin)) {
+    showHelp();
+    Logger::printError() << "--test option requires --bot or --plugin option";
+    return false;
   }
 
+  bot = newBot();
+
   return true;
 }
 
@@ -150,32 +164,44 @@ bool Client::run() {
   Screen::get(true).clear().flush();
   bool ok = waitForGameStart();
 
+  Coordinate coord;
+  bool userInput = false;
   while (ok && !game.isFinished()) {
-    Coordinate coord(1, 1);
-    Screen::print() << coord << ClearToScreenEnd;
-    for (auto& board : game.getBoards()) {
-      if (board->print(true, &game.getConfiguration())) {
-        coord.set(board->getBottomRight());
+    if (dirty && (userInput || !frameWait())) {
+      dirty = false;
+      frameTimer.tick();
+
+      // boards only redraw squares that changed, so clear below them
+      coord.set(1, 1);
+      for (auto& board : game.getBoards()) {
+        if (board->print(true, &game.getConfiguration())) {
+          coord.set(board->getBottomRight());
+        }
       }
-    }
 
-    printMessages(coord.south().setX(1));
-    printGameOptions(coord);
+      Screen::print() << coord.south().setX(1) << ClearToScreenEnd;
+      printMessages(coord);
+      printGameOptions(coord);
 
-    Screen::print() << " -> " << Flush;
-    if (waitForInput()) {
+      Screen::print() << " -> " << Flush;
+    }
+    if (userInput) {
       switch (getKey(coord)) {
       case 'C': clearMessages(coord);  break;
       case 'K': skip(coord);           break;
       case 'M': sendMessage(coord);    break;
       case 'Q': ok = !quitGame(coord); break;
-      case 'R': redrawScreen();        break;
+      case 'R': redrawScreen(true);    break;
       case 'S': shoot(coord);          break;
       case 'T': setTaunts();           break;
       case 'V': viewBoard(coord);      break;
       default:
         break;
       }
+      dirty = true;
+    }
+    if (ok) {
+      userInput = waitForInput(frameWait());
     }
   }
 
@@ -185,13 +211,37 @@ bool Client::run() {
 //-----------------------------------------------------------------------------
 bool Client::runTest() {
   if (!bot) {
-    throw Error("--test option requires --bot option");
-  } else {
-    BotTester().test(*bot);
+    throw Error("--test option requires --bot or --plugin option");
   }
+
+  // start all worker processes before BotTester starts any threads
+  const CommandArgs& args = CommandArgs::getInstance();
+  const unsigned count = args.getUIntAfter({"-j", "--workers"}, 1);
+  std::vector<std::unique_ptr<Bot>> workers;
+  std::vector<Bot*> bots(1, bot.get());
+  for (unsigned i = 1; i < count; ++i) {
+    workers.push_back(newBot());
+    bots.push_back(workers.back().get());
+  }
+
+  BotTester().test(bots);
   return true;
 }
 
+//-----------------------------------------------------------------------------
+std::unique_ptr<Bot> Client::newBot() const {
+  std::unique_ptr<Bot> newBot;
+  if (botPlugin.size()) {
+    newBot.reset(new PluginBot(botPlugin));
+  } else if (botCommand.size()) {
+    newBot.reset(new ShellBot(botCommand, botTimeout));
+  } else {
+    return newBot;
+  }
+  newBot->setStaticBoard(staticBoard);
+  return newBot;
+}
+
 //-----------------------------------------------------------------------------
 Board& Client::myBoard() {
   auto board = game.boardForPlayer(userName, true);
@@ -264,7 +314,8 @@ bool Client::getUserName(const bool gameStarted) {
   if (bot) {
     userName = bot->getPlayerName();
     if (isEmpty(userName)) {
-      throw Error(Msg() << "No player name from bot '" << botCommand << "'");
+      throw Error(Msg() << "No player name from bot '" << bot->getBotName()
+                  << "'");
     }
   } else {
     userName = getUserArg();
@@ -314,12 +365,10 @@ bool Client::joinGame(const bool gameStarted, bool& retry) {
   }
 
   const Configuration& config = game.getConfiguration();
+  CSVWriter joinMsg = Msg('J') << userName;
   if (gameStarted) {
-    // rejoining game in progress
-    if (!trySend(Msg('J') << userName)) {
-      Logger::printError() << "Failed to send join message to server";
-      return false;
-    }
+    // rejoining game in progress, join options follow the board value so
+    // without a board there are none
     yourBoard.reset(new Board(userName, config));
   } else {
     // joining a game that hasn't started yet
@@ -327,12 +376,18 @@ bool Client::joinGame(const bool gameStarted, bool& retry) {
       Logger::printError() << "Your board is not setup!";
       return false;
     }
-    if (!trySend(Msg('J') << userName << yourBoard->getDescriptor())) {
-      Logger::printError() << "Failed to send join message to server";
-      return false;
+    joinMsg << yourBoard->getDescriptor()
+            << Server::DELTA_OPTION << Server::PING_OPTION;
+    if (binary) {
+      joinMsg << Server::BINARY_OPTION;
     }
   }
 
+  if (!trySend(joinMsg)) {
+    Logger::printError() << "Failed to send join message to server";
+    return false;
+  }
+
   if (!input.readln(socket.getHandle())) {
     Logger::printError() << "No respone from server";
     return false;
@@ -345,6 +400,12 @@ bool Client::joinGame(const bool gameStarted, bool& retry) {
                            << input.getLine() << "'";
       return false;
     }
+    for (unsigned i = 2; i < input.getFieldCount(); ++i) {
+      if (input.getStr(i) == Server::BINARY_OPTION) {
+        socket.setBinary(true);
+        input.setBinary(socket.getHandle(), true);
+      }
+    }
     yourBoard->setName(userName);
     game.addBoard(std::make_shared<Board>(userName, config));
     if (gameStarted) {
@@ -689,36 +750,46 @@ bool Client::waitForGameStart() {
     throw Error("Your board setup is invalid!");
   }
 
+  Coordinate coord;
   bool ok = true;
+  bool userInput = false;
   while (ok && !game.isStarted() && !game.isFinished()) {
-    Coordinate coord(1, 1);
-    Screen::print() << coord << ClearToScreenEnd;
-    game.getConfiguration().print(coord);
+    if (dirty && (userInput || !frameWait())) {
+      dirty = false;
+      frameTimer.tick();
 
-    Screen::print() << coord.south() << "Joined : " << game.getBoardCount();
-    coord.south().setX(3);
+      Screen::print() << coord.set(1, 1) << ClearToScreenEnd;
+      game.getConfiguration().print(coord);
 
-    for (auto& board : game.getBoards()) {
-      Screen::print() << coord.south() << board->getName();
-      if (userName == board->getName()) {
-        Screen::print() << " (you)";
+      Screen::print() << coord.south() << "Joined : " << game.getBoardCount();
+      coord.south().setX(3);
+
+      for (auto& board : game.getBoards()) {
+        Screen::print() << coord.south() << board->getName();
+        if (userName == board->getName()) {
+          Screen::print() << " (you)";
+        }
       }
-    }
 
-    printMessages(coord.south().setX(1));
-    printWaitOptions(coord);
+      printMessages(coord.south().setX(1));
+      printWaitOptions(coord);
 
-    Screen::print() << " -> " << Flush;
-    if (waitForInput()) {
+      Screen::print() << " -> " << Flush;
+    }
+    if (userInput) {
       switch (getKey(coord)) {
       case 'C': clearMessages(coord);  break;
       case 'M': sendMessage(coord);    break;
       case 'Q': ok = !quitGame(coord); break;
-      case 'R': redrawScreen();        break;
+      case 'R': redrawScreen(true);    break;
       case 'T': setTaunts();           break;
       default:
         break;
       }
+      dirty = true;
+    }
+    if (ok) {
+      userInput = waitForInput(frameWait());
     }
   }
 
@@ -729,7 +800,9 @@ bool Client::waitForGameStart() {
 bool Client::waitForInput(const int timeout) {
   std::set<int> ready;
   if (!input.waitForData(ready, timeout)) {
-    redrawScreen();
+    if ((timeout < 0) || Screen::get().isResized()) {
+      redrawScreen();
+    }
     return false;
   }
 
@@ -737,6 +810,7 @@ bool Client::waitForInput(const int timeout) {
   for (const int handle : ready) {
     if (isServerHandle(handle)) {
       handleServerMessage();
+      dirty = true;
     } else {
       userInput = isUserHandle(handle);
     }
@@ -744,6 +818,15 @@ bool Client::waitForInput(const int timeout) {
   return userInput;
 }
 
+//-----------------------------------------------------------------------------
+int Client::frameWait() const noexcept {
+  if (!dirty) {
+    return -1;
+  }
+  const Milliseconds elapsed = frameTimer.tock();
+  return (elapsed < FRAME_INTERVAL) ? int(FRAME_INTERVAL - elapsed) : 0;
+}
+
 //-----------------------------------------------------------------------------
 char Client::getChar() {
   CanonicalMode cmode(false);
@@ -960,6 +1043,7 @@ void Client::handleServerMessage() {
     if (str.size() == 1) {
       switch (str[0]) {
       case 'B': updateBoard();     return;
+      case 'D': updateSquares();   return;
       case 'F': endGame();         return;
       case 'H': hit();             return;
       case 'J': addPlayer();       return;
@@ -967,6 +1051,7 @@ void Client::handleServerMessage() {
       case 'L': removePlayer();    return;
       case 'M': addMessage();      return;
       case 'N': nextTurn();        return;
+      case 'P':                    return; // keepalive
       case 'S': startGame();       return;
       default:
         break;
@@ -1022,10 +1107,10 @@ void Client::nextTurn() {
     bot->updatePlayerToMove(name);
     if (name == userName) {
       Coordinate shotCoord;
-      Logger::debug() << "waiting for shoot message from bot("
+      XBS_LOG_DEBUG() << "waiting for shoot message from bot("
                       << bot->getBotName() << ')';
       std::string target = bot->getBestShot(shotCoord);
-      Logger::debug() << "bot target: " << target << ", coord: " << shotCoord;
+      XBS_LOG_DEBUG() << "bot target: " << target << ", coord: " << shotCoord;
       if (isEmpty(target)) {
         myBoard().incSkips();
         send(Msg('K') << userName);
@@ -1097,7 +1182,11 @@ void Client::printWaitOptions(Coordinate coord) {
 }
 
 //-----------------------------------------------------------------------------
-void Client::redrawScreen() {
+void Client::redrawScreen(const bool repaint) {
+  if (repaint) {
+    Screen::get().invalidate();
+  }
+  dirty = true;
   clearScreen();
   std::vector<Rectangle*> children;
   for (auto& child : game.getBoards()) {
@@ -1424,6 +1513,55 @@ void Client::updateBoard() {
   }
 }
 
+//-----------------------------------------------------------------------------
+void Client::updateSquares() {
+  const std::string name   = input.getStr(1);
+  const std::string status = input.getStr(2);
+  const unsigned score     = input.getUInt(3);
+  const unsigned skips     = input.getUInt(4);
+  const unsigned count     = input.getFieldCount();
+
+  auto board = game.boardForPlayer(name, true);
+  if (!board || (count < 5) || !(count % 2)) {
+    throw Error(Msg() << "Invalid board update message from server: "
+                << input.getLine());
+  }
+
+  SquareUpdates squares;
+  for (unsigned i = 5; i < count; i += 2) {
+    const std::string value = input.getStr(i + 1);
+    if (value.size() != 1) {
+      throw Error(Msg() << "Invalid board update message from server: "
+                  << input.getLine());
+    }
+    squares.push_back(std::make_pair(input.getUInt(i, ~0U), value[0]));
+  }
+
+  // validate the whole update before changing anything
+  if (!board->canUpdateSquares(squares)) {
+    throw Error(Msg() << "Failed to update board squares for " << name);
+  } else if (name == userName) {
+    for (const auto& square : squares) {
+      if (!yourBoard->canAddHitOrMiss(square.first, square.second)) {
+        throw Error(Msg() << "Board update mismatch: " << input.getLine());
+      }
+    }
+  }
+
+  board->setStatus(status).setScore(score).setSkips(skips);
+  board->updateSquares(squares);
+  if (name == userName) {
+    for (const auto& square : squares) {
+      yourBoard->addHitOrMiss(square.first, square.second);
+    }
+  }
+
+  if (bot) {
+    // shell bots always receive the full board descriptor
+    bot->updateBoard(name, status, board->getDescriptor(), score, skips);
+  }
+}
+
 //-----------------------------------------------------------------------------
 void Client::updateYourBoard() {
   const std::string desc = input.getStr(1);
@@ -1452,6 +1590,7 @@ void Client::viewBoard(Coordinate coord) {
   Screen::print() << coord << ClearToLineEnd << "Press any key" << Flush;
   getKey(coord);
 
+  board.invalidatePrint();
   if (!board.print(true, &game.getConfiguration())) {
     throw Error("Failed to print your board");
   }
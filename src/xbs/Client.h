@@ -13,6 +13,7 @@
 #include "Msg.h"
 #include "ShellBot.h"
 #include "TcpSocket.h"
+#include "Timer.h"
 #include "Version.h"
 #include "db/FileSysDBRecord.h"
 
@@ -21,11 +22,21 @@ namespace xbs
 
 //-----------------------------------------------------------------------------
 class Client {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    FRAME_INTERVAL = 33 // milliseconds, redraw at most 30 times per second
+  };
+
 //-----------------------------------------------------------------------------
 private: // variables
   unsigned msgEnd = ~0U;
   int port = -1;
   bool test = false;
+  bool binary = false;
+  bool dirty = true; // screen needs to be redrawn
+  Timer frameTimer;
+  Milliseconds botTimeout = ShellBot::DEFAULT_REPLY_TIMEOUT;
   TcpSocket socket;
   Input input;
   Game game;
@@ -33,11 +44,12 @@ private: // variables
   std::string userName;
   std::string staticBoard;
   std::string botCommand;
+  std::string botPlugin;
   std::vector<Message> messages;
   std::vector<std::string> msgBuffer;
   std::unique_ptr<FileSysDBRecord> taunts;
   std::unique_ptr<Board> yourBoard;
-  std::unique_ptr<ShellBot> bot;
+  std::unique_ptr<Bot> bot;
 
 //-----------------------------------------------------------------------------
 public: // constructors
@@ -68,6 +80,7 @@ public: // methods
 //-----------------------------------------------------------------------------
 private: // methods
   Board& myBoard();
+  std::unique_ptr<Bot> newBot() const;
 
   std::string prompt(Coordinate, const std::string& question,
                      const char fieldDelimeter = 0);
@@ -93,6 +106,8 @@ private: // methods
   char getChar();
   char getKey(Coordinate);
 
+  int frameWait() const noexcept;
+
   unsigned msgHeaderLen() const noexcept;
   unsigned msgWindowHeight(Coordinate) const;
 
@@ -115,7 +130,7 @@ private: // methods
   void printGameOptions(Coordinate);
   void printMessages(Coordinate&); // this one uses reference intentionally
   void printWaitOptions(Coordinate);
-  void redrawScreen();
+  void redrawScreen(const bool repaint = false);
   void removePlayer();
   void scrollDown() noexcept;
   void scrollHome() noexcept;
@@ -130,6 +145,7 @@ private: // methods
   void skip(Coordinate);
   void startGame();
   void updateBoard();
+  void updateSquares();
   void updateYourBoard();
   void viewBoard(Coordinate);
 };
@@ -8,28 +8,27 @@
 #include "Platform.h"
 #include "CSVReader.h"
 #include "Movement.h"
-#include "Printable.h"
+#include <type_traits>
 
 namespace xbs
 {
 
 //-----------------------------------------------------------------------------
-class Coordinate : public Printable {
+// A 1-based x,y position.  Kept trivially copyable with no vtable so vectors
+// of coordinates stay compact, callers that rank coordinates keep their
+// scores in a separate array.  Values that don't fit in 16 bits become 0.
 //-----------------------------------------------------------------------------
-public: // Printable implementaion
-  virtual std::string toString() const {
-    if (x < 26) {
-      return (static_cast<char>('a' + x - 1) + toStr(y)); // "a1" format
-    } else {
-      return (toStr(x) + ',' + toStr(y));                 // "1,1" format
-    }
-  }
+class Coordinate {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum : unsigned {
+    MAX_VALUE = 0xFFFF
+  };
 
 //-----------------------------------------------------------------------------
 private: // variables
-  unsigned x = 0;
-  unsigned y = 0;
-  double score = 0;
+  u_int16_t x = 0;
+  u_int16_t y = 0;
 
 //-----------------------------------------------------------------------------
 public: // constructors
@@ -39,12 +38,9 @@ public: // constructors
   Coordinate& operator=(Coordinate&&) noexcept = default;
   Coordinate& operator=(const Coordinate&) noexcept = default;
 
-  explicit Coordinate(const unsigned x,
-                      const unsigned y,
-                      const double score = 0) noexcept
-    : x(x),
-      y(y),
-      score(score)
+  explicit Coordinate(const unsigned x, const unsigned y) noexcept
+    : x(clip(x)),
+      y(clip(y))
   { }
 
 //-----------------------------------------------------------------------------
@@ -52,15 +48,18 @@ public: // methods
   unsigned getX() const noexcept { return x; }
   unsigned getY() const noexcept { return y; }
   unsigned parity() const noexcept { return ((x & 1) == (y & 1)); }
-  double getScore() const noexcept { return score; }
-
-  Coordinate& set(const unsigned x,
-                  const unsigned y,
-                  const double score = 0) noexcept
-  {
-    this->x = x;
-    this->y = y;
-    this->score = score;
+
+  std::string toString() const {
+    if (x < 26) {
+      return (static_cast<char>('a' + x - 1) + toStr(y)); // "a1" format
+    } else {
+      return (toStr(x) + ',' + toStr(y));                 // "1,1" format
+    }
+  }
+
+  Coordinate& set(const unsigned x, const unsigned y) noexcept {
+    this->x = clip(x);
+    this->y = clip(y);
     return (*this);
   }
 
@@ -69,21 +68,16 @@ public: // methods
   }
 
   Coordinate& set(const Coordinate& other) noexcept {
-    return set(other.x, other.y);
+    return ((*this) = other);
   }
 
   Coordinate& setX(const unsigned x) noexcept {
-    this->x = x;
+    this->x = clip(x);
     return (*this);
   }
 
   Coordinate& setY(const unsigned y) noexcept {
-    this->y = y;
-    return (*this);
-  }
-
-  Coordinate& setScore(const double score) noexcept {
-    this->score = score;
+    this->y = clip(y);
     return (*this);
   }
 
@@ -93,12 +87,12 @@ public: // methods
   }
 
   Coordinate& east(const unsigned count = 1) noexcept {
-    x = ((*this) && ((x + count) >= x)) ? (x + count) : 0;
+    x = ((*this) && (count <= (MAX_VALUE - x))) ? (x + count) : 0;
     return (*this);
   }
 
   Coordinate& south(const unsigned count = 1) noexcept {
-    y = ((*this) && ((y + count) >= y)) ? (y + count) : 0;
+    y = ((*this) && (count <= (MAX_VALUE - y))) ? (y + count) : 0;
     return (*this);
   }
 
@@ -126,15 +120,15 @@ public: // methods
     std::string yCell;
     CSVReader(str) >> xCell >> yCell;
     if (isUInt(xCell) && isUInt(yCell)) {
-      x = toUInt32(xCell);
-      y = toUInt32(yCell);
+      x = clip(toUInt32(xCell));
+      y = clip(toUInt32(yCell));
       return true;
     }
     if (yCell.empty() && (xCell.size() > 1) && isalpha(xCell[0]) &&
         isUInt(xCell.substr(1)))
     {
-      x = static_cast<unsigned>(tolower(xCell[0]) - 'a' + 1);
-      y = toUInt32(xCell.substr(1));
+      x = static_cast<u_int16_t>(tolower(xCell[0]) - 'a' + 1);
+      y = clip(toUInt32(xCell.substr(1)));
       return true;
     }
     return false;
@@ -159,8 +153,32 @@ public: // operator overloads
   bool operator!=(const Coordinate& other) const noexcept {
     return !operator==(other);
   }
+
+//-----------------------------------------------------------------------------
+private: // static methods
+  static u_int16_t clip(const unsigned value) noexcept {
+    return static_cast<u_int16_t>((value <= MAX_VALUE) ? value : 0);
+  }
 };
 
+static_assert(std::is_trivially_copyable<Coordinate>::value,
+              "Coordinate must be trivially copyable");
+
+//-----------------------------------------------------------------------------
+inline std::ostream& operator<<(std::ostream& os, const Coordinate& coord) {
+  return (os << coord.toString());
+}
+
+//-----------------------------------------------------------------------------
+inline std::string& operator+=(std::string& str, const Coordinate& coord) {
+  return (str += coord.toString());
+}
+
+//-----------------------------------------------------------------------------
+inline void appendStr(std::string& dest, const Coordinate& coord) {
+  dest += coord;
+}
+
 } // namespace xbs
 
 #endif // XBS_COORDINATE_H
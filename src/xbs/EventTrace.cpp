@@ -0,0 +1,320 @@
+//-----------------------------------------------------------------------------
+// EventTrace.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "EventTrace.h"
+#include "Error.h"
+#include "Logger.h"
+#include "Msg.h"
+#include "StringUtils.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// trace file layout:
+//   MAGIC
+//   event*
+//
+// event layout:
+//   u8 type, num microseconds since previous event, payload
+//
+// payload layout by event type:
+//   SessionEvent:    u64 microseconds since epoch (little endian)
+//   PlayerNameEvent: num playerID, str name
+//   GameStartEvent:  str title, num width, num height, num boardCount
+//   GameFinishEvent: num turnCount
+//   GameAbortEvent:  num turnCount
+//   JoinEvent:       num playerID, str descriptor
+//   RejoinEvent:     num playerID
+//   LeaveEvent:      num playerID
+//   TurnEvent:       num playerID
+//   ShotEvent:       num shooterID, num targetID, num x, num y, u8 result
+//   SkipEvent:       num playerID
+//
+// num layout:
+//   unsigned LEB128, 7 bits per byte, low bits first
+//
+// str layout:
+//   num length, char[length]
+//
+// a PlayerNameEvent is written before the first event that refers to a
+// player, player IDs are only valid until the next SessionEvent
+//-----------------------------------------------------------------------------
+const char EventTrace::MAGIC[8] = { 'X', 'B', 'S', 'T', 'R', 'C', '0', '1' };
+
+//-----------------------------------------------------------------------------
+std::string EventTrace::toString() const {
+  return ("EventTrace(" + tracePath + ")");
+}
+
+//-----------------------------------------------------------------------------
+EventTrace& EventTrace::open(const std::string& traceFilePath) {
+  close();
+
+  if (isEmpty(traceFilePath)) {
+    throw Error("EventTrace.open() empty path");
+  }
+
+  fd = ::open(traceFilePath.c_str(),
+              (O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC), 0640);
+  if (fd < 0) {
+    throw Error(Msg() << "open(" << traceFilePath << ") failed: "
+                << toError(errno));
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    const int err = errno;
+    ::close(fd);
+    fd = -1;
+    throw Error(Msg() << "fstat(" << traceFilePath << ") failed: "
+                << toError(err));
+  }
+
+  tracePath = traceFilePath;
+  buffer.clear();
+  playerIDs.clear();
+  if (!st.st_size) {
+    buffer.append(MAGIC, sizeof(MAGIC));
+  }
+
+  // every session starts with an absolute timestamp
+  const auto now = std::chrono::system_clock::now().time_since_epoch();
+  u_int64_t usecs = std::chrono::duration_cast<std::chrono::microseconds>(
+      now).count();
+
+  lastEvent = std::chrono::steady_clock::now();
+  buffer += static_cast<char>(SessionEvent);
+  putNumber(0);
+  for (unsigned i = 0; i < sizeof(usecs); ++i) {
+    buffer += static_cast<char>(usecs & 0xFF);
+    usecs >>= 8;
+  }
+
+  Logger::info() << "Recording game events to " << tracePath;
+  return (*this);
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::close() noexcept {
+  if (fd >= 0) {
+    flush();
+  }
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+  buffer.clear();
+  playerIDs.clear();
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::flush() noexcept {
+  if ((fd >= 0) && buffer.size()) {
+    try {
+      writeBuffer();
+    }
+    catch (const std::exception& e) {
+      Logger::error() << e.what();
+    }
+  }
+  buffer.clear();
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::gameStarted(const std::string& title,
+                             const unsigned width,
+                             const unsigned height,
+                             const unsigned boardCount) noexcept
+{
+  if (fd >= 0) {
+    try {
+      beginEvent(GameStartEvent);
+      putString(title);
+      putNumber(width);
+      putNumber(height);
+      putNumber(boardCount);
+    }
+    catch (const std::exception& e) {
+      Logger::error() << (*this) << " " << e.what();
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::gameFinished(const unsigned turnCount) noexcept {
+  if (fd >= 0) {
+    try {
+      beginEvent(GameFinishEvent);
+      putNumber(turnCount);
+    }
+    catch (const std::exception& e) {
+      Logger::error() << (*this) << " " << e.what();
+    }
+    flush();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::gameAborted(const unsigned turnCount) noexcept {
+  if (fd >= 0) {
+    try {
+      beginEvent(GameAbortEvent);
+      putNumber(turnCount);
+    }
+    catch (const std::exception& e) {
+      Logger::error() << (*this) << " " << e.what();
+    }
+    flush();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::playerJoined(const std::string& player,
+                              const std::string& descriptor) noexcept
+{
+  if (fd >= 0) {
+    try {
+      const unsigned id = playerID(player);
+      beginEvent(JoinEvent);
+      putNumber(id);
+      putString(descriptor);
+    }
+    catch (const std::exception& e) {
+      Logger::error() << (*this) << " " << e.what();
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::playerRejoined(const std::string& player) noexcept {
+  playerEvent(RejoinEvent, player);
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::playerLeft(const std::string& player) noexcept {
+  playerEvent(LeaveEvent, player);
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::turnStarted(const std::string& player) noexcept {
+  playerEvent(TurnEvent, player);
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::turnSkipped(const std::string& player) noexcept {
+  playerEvent(SkipEvent, player);
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::shotTaken(const std::string& shooter,
+                           const std::string& target,
+                           const Coordinate& coord,
+                           const char result) noexcept
+{
+  if (fd >= 0) {
+    try {
+      const unsigned shooterID = playerID(shooter);
+      const unsigned targetID = playerID(target);
+      beginEvent(ShotEvent);
+      putNumber(shooterID);
+      putNumber(targetID);
+      putNumber(coord.getX());
+      putNumber(coord.getY());
+      buffer += result;
+    }
+    catch (const std::exception& e) {
+      Logger::error() << (*this) << " " << e.what();
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::playerEvent(const TraceEventType type,
+                             const std::string& player) noexcept
+{
+  if (fd >= 0) {
+    try {
+      const unsigned id = playerID(player);
+      beginEvent(type);
+      putNumber(id);
+    }
+    catch (const std::exception& e) {
+      Logger::error() << (*this) << " " << e.what();
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+unsigned EventTrace::playerID(const std::string& player) {
+  auto it = playerIDs.find(player);
+  if (it != playerIDs.end()) {
+    return it->second;
+  }
+
+  const unsigned id = playerIDs.size();
+  playerIDs[player] = id;
+  beginEvent(PlayerNameEvent);
+  putNumber(id);
+  putString(player);
+  return id;
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::beginEvent(const TraceEventType type) {
+  if (buffer.size() >= BUFFER_SIZE) {
+    writeBuffer();
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  const auto usecs = std::chrono::duration_cast<std::chrono::microseconds>(
+      now - lastEvent).count();
+
+  lastEvent = now;
+  buffer += static_cast<char>(type);
+  putNumber((usecs > 0) ? static_cast<u_int64_t>(usecs) : 0);
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::putNumber(u_int64_t num) {
+  while (num >= 0x80) {
+    buffer += static_cast<char>((num & 0x7F) | 0x80);
+    num >>= 7;
+  }
+  buffer += static_cast<char>(num);
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::putString(const std::string& str) {
+  putNumber(str.size());
+  buffer += str;
+}
+
+//-----------------------------------------------------------------------------
+void EventTrace::writeBuffer() {
+  const char* data = buffer.data();
+  size_t remain = buffer.size();
+  while (remain) {
+    const ssize_t n = ::write(fd, data, remain);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // stop recording, the rest of the trace would be unreadable anyway
+      const int err = errno;
+      ::close(fd);
+      fd = -1;
+      buffer.clear();
+      throw Error(Msg() << "write(" << tracePath << ") failed: "
+                  << toError(err));
+    }
+    data += n;
+    remain -= static_cast<size_t>(n);
+  }
+  buffer.clear();
+}
+
+} // namespace xbs
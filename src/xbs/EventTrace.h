@@ -0,0 +1,145 @@
+//-----------------------------------------------------------------------------
+// EventTrace.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_EVENT_TRACE_H
+#define XBS_EVENT_TRACE_H
+
+#include "Platform.h"
+#include "Coordinate.h"
+#include "Printable.h"
+#include <chrono>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+typedef int64_t Microseconds;
+
+//-----------------------------------------------------------------------------
+enum TraceEventType {
+  SessionEvent = 1,
+  PlayerNameEvent,
+  GameStartEvent,
+  GameFinishEvent,
+  GameAbortEvent,
+  JoinEvent,
+  RejoinEvent,
+  LeaveEvent,
+  TurnEvent,
+  ShotEvent,
+  SkipEvent
+};
+
+//-----------------------------------------------------------------------------
+// A decoded trace event, fields not used by the event type are left empty
+//-----------------------------------------------------------------------------
+struct TraceEvent {
+  TraceEventType type = SessionEvent;
+  Microseconds time = 0; // since epoch
+  std::string player;
+  std::string target;
+  std::string text; // game title or board descriptor
+  unsigned x = 0; // shot column or board width
+  unsigned y = 0; // shot row or board height
+  unsigned count = 0; // board count or turn count
+  char result = 0;
+};
+
+//-----------------------------------------------------------------------------
+// The EventTrace class records game events to a compact append-only binary
+// file: joins, turns, shots with target and result, skips, and the start
+// and end of every game, each with a microsecond timestamp.  Events are
+// buffered in memory and written when the buffer is full, when a game ends,
+// and on flush() or close().
+//
+// Write errors are logged and close the trace, the trace is telemetry and
+// never interrupts a game.  Not thread safe, every event must be recorded
+// by the same thread.
+//-----------------------------------------------------------------------------
+class EventTrace : public Printable {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    BUFFER_SIZE = (64 * 1024)
+  };
+
+//-----------------------------------------------------------------------------
+private: // variables
+  int fd = -1;
+  std::string tracePath;
+  std::string buffer;
+  std::map<std::string, unsigned> playerIDs;
+  std::chrono::steady_clock::time_point lastEvent;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  EventTrace() = default;
+  EventTrace(EventTrace&&) = delete;
+  EventTrace(const EventTrace&) = delete;
+  EventTrace& operator=(EventTrace&&) = delete;
+  EventTrace& operator=(const EventTrace&) = delete;
+
+//-----------------------------------------------------------------------------
+public: // destructor
+  ~EventTrace() { close(); }
+
+//-----------------------------------------------------------------------------
+public: // Printable implementation
+  std::string toString() const override;
+
+//-----------------------------------------------------------------------------
+public: // static constants
+  static const char MAGIC[8];
+
+//-----------------------------------------------------------------------------
+public: // methods
+  /**
+   * @brief Open the given trace file, create it if it doesn't exist
+   * @param traceFilePath Path to the trace file, new events are appended
+   */
+  EventTrace& open(const std::string& traceFilePath);
+
+  void close() noexcept;
+  void flush() noexcept;
+  bool isOpen() const noexcept { return (fd >= 0); }
+  std::string getPath() const { return tracePath; }
+
+  void gameStarted(const std::string& title,
+                   const unsigned width,
+                   const unsigned height,
+                   const unsigned boardCount) noexcept;
+
+  void gameFinished(const unsigned turnCount) noexcept;
+  void gameAborted(const unsigned turnCount) noexcept;
+  void playerJoined(const std::string& player,
+                    const std::string& descriptor) noexcept;
+  void playerRejoined(const std::string& player) noexcept;
+  void playerLeft(const std::string& player) noexcept;
+  void turnStarted(const std::string& player) noexcept;
+  void turnSkipped(const std::string& player) noexcept;
+
+  /**
+   * @param shooter The name of the player taking the shot
+   * @param target The name of the player being shot at
+   * @param coord The square being shot at
+   * @param result The value of the target square before the shot
+   */
+  void shotTaken(const std::string& shooter,
+                 const std::string& target,
+                 const Coordinate& coord,
+                 const char result) noexcept;
+
+//-----------------------------------------------------------------------------
+private: // methods
+  unsigned playerID(const std::string& player);
+  void beginEvent(const TraceEventType);
+  void playerEvent(const TraceEventType, const std::string& player) noexcept;
+  void putNumber(u_int64_t);
+  void putString(const std::string&);
+  void writeBuffer();
+};
+
+} // namespace xbs
+
+#endif // XBS_EVENT_TRACE_H
@@ -0,0 +1,215 @@
+//-----------------------------------------------------------------------------
+// EventTraceReader.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "EventTraceReader.h"
+#include "Error.h"
+#include "Msg.h"
+#include "StringUtils.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+std::string EventTraceReader::toString() const {
+  return ("EventTraceReader(" + tracePath + ")");
+}
+
+//-----------------------------------------------------------------------------
+EventTraceReader& EventTraceReader::open(const std::string& traceFilePath) {
+  if (isEmpty(traceFilePath)) {
+    throw Error("EventTraceReader.open() empty path");
+  }
+
+  std::ifstream file(traceFilePath.c_str(), std::ios::binary);
+  if (!file) {
+    throw Error(Msg() << "Cannot open " << traceFilePath << ": "
+                << toError(errno));
+  }
+
+  std::stringstream ss;
+  ss << file.rdbuf();
+  data = ss.str();
+  tracePath = traceFilePath;
+  truncated = false;
+  lastTime = 0;
+  players.clear();
+
+  if ((data.size() < sizeof(EventTrace::MAGIC)) ||
+      memcmp(data.data(), EventTrace::MAGIC, sizeof(EventTrace::MAGIC)))
+  {
+    throw Error(Msg() << "'" << traceFilePath << "' is not an event trace");
+  }
+
+  pos = sizeof(EventTrace::MAGIC);
+  return (*this);
+}
+
+//-----------------------------------------------------------------------------
+bool EventTraceReader::next(TraceEvent& event) {
+  while (pos < data.size()) {
+    const size_t start = pos;
+    event = TraceEvent();
+    if (!decode(event)) {
+      pos = start;
+      truncated = true;
+      return false;
+    }
+    if (event.type != PlayerNameEvent) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+bool EventTraceReader::decode(TraceEvent& event) {
+  unsigned char type = 0;
+  u_int64_t usecs = 0;
+  if (!getByte(type) || !getNumber(usecs)) {
+    return false;
+  }
+
+  event.type = static_cast<TraceEventType>(type);
+  switch (event.type) {
+  case SessionEvent:
+    usecs = 0;
+    for (unsigned i = 0; i < sizeof(usecs); ++i) {
+      unsigned char ch = 0;
+      if (!getByte(ch)) {
+        return false;
+      }
+      usecs |= (static_cast<u_int64_t>(ch) << (8 * i));
+    }
+    lastTime = static_cast<Microseconds>(usecs);
+    players.clear();
+    break;
+  case PlayerNameEvent: {
+    u_int64_t id = 0;
+    if (!getNumber(id) || !getString(event.player)) {
+      return false;
+    }
+    players[id] = event.player;
+    lastTime += usecs;
+    break;
+  }
+  case GameStartEvent:
+    if (!getString(event.text) ||
+        !getNumber(event.x) ||
+        !getNumber(event.y) ||
+        !getNumber(event.count))
+    {
+      return false;
+    }
+    lastTime += usecs;
+    break;
+  case GameFinishEvent:
+  case GameAbortEvent:
+    if (!getNumber(event.count)) {
+      return false;
+    }
+    lastTime += usecs;
+    break;
+  case JoinEvent:
+    if (!getPlayer(event.player) || !getString(event.text)) {
+      return false;
+    }
+    lastTime += usecs;
+    break;
+  case RejoinEvent:
+  case LeaveEvent:
+  case TurnEvent:
+  case SkipEvent:
+    if (!getPlayer(event.player)) {
+      return false;
+    }
+    lastTime += usecs;
+    break;
+  case ShotEvent: {
+    unsigned char result = 0;
+    if (!getPlayer(event.player) ||
+        !getPlayer(event.target) ||
+        !getNumber(event.x) ||
+        !getNumber(event.y) ||
+        !getByte(result))
+    {
+      return false;
+    }
+    event.result = static_cast<char>(result);
+    lastTime += usecs;
+    break;
+  }
+  default:
+    throw Error(Msg() << "Invalid event type (" << unsigned(type)
+                << ") in " << (*this) << " at offset " << pos);
+  }
+
+  event.time = lastTime;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool EventTraceReader::getByte(unsigned char& ch) noexcept {
+  if (pos < data.size()) {
+    ch = static_cast<unsigned char>(data[pos++]);
+    return true;
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+bool EventTraceReader::getNumber(u_int64_t& num) noexcept {
+  num = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    unsigned char ch = 0;
+    if (!getByte(ch)) {
+      return false;
+    }
+    num |= (static_cast<u_int64_t>(ch & 0x7F) << shift);
+    if (!(ch & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+bool EventTraceReader::getNumber(unsigned& num) noexcept {
+  u_int64_t tmp = 0;
+  if (getNumber(tmp)) {
+    num = static_cast<unsigned>(tmp);
+    return true;
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+bool EventTraceReader::getString(std::string& str) {
+  u_int64_t len = 0;
+  if (!getNumber(len) || (len > (data.size() - pos))) {
+    return false;
+  }
+  str.assign(data, pos, len);
+  pos += len;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool EventTraceReader::getPlayer(std::string& name) {
+  u_int64_t id = 0;
+  if (!getNumber(id)) {
+    return false;
+  }
+  auto it = players.find(id);
+  if (it == players.end()) {
+    throw Error(Msg() << "Unknown player ID (" << id << ") in " << (*this)
+                << " at offset " << pos);
+  }
+  name = it->second;
+  return true;
+}
+
+} // namespace xbs
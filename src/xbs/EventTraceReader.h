@@ -0,0 +1,70 @@
+//-----------------------------------------------------------------------------
+// EventTraceReader.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_EVENT_TRACE_READER_H
+#define XBS_EVENT_TRACE_READER_H
+
+#include "Platform.h"
+#include "EventTrace.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// The EventTraceReader class decodes the events in a file written by the
+// EventTrace class.  Player IDs are resolved to player names and event
+// times are converted to microseconds since epoch.
+//-----------------------------------------------------------------------------
+class EventTraceReader : public Printable {
+//-----------------------------------------------------------------------------
+private: // variables
+  bool truncated = false;
+  size_t pos = 0;
+  Microseconds lastTime = 0;
+  std::string tracePath;
+  std::string data;
+  std::map<u_int64_t, std::string> players;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  EventTraceReader() = default;
+  EventTraceReader(EventTraceReader&&) = delete;
+  EventTraceReader(const EventTraceReader&) = delete;
+  EventTraceReader& operator=(EventTraceReader&&) = delete;
+  EventTraceReader& operator=(const EventTraceReader&) = delete;
+
+//-----------------------------------------------------------------------------
+public: // Printable implementation
+  std::string toString() const override;
+
+//-----------------------------------------------------------------------------
+public: // methods
+  EventTraceReader& open(const std::string& traceFilePath);
+
+  /**
+   * @brief Decode the next event
+   * @param event Populated with the next event
+   * @return false if there are no more events
+   */
+  bool next(TraceEvent& event);
+
+  /**
+   * @return true if the trace ends with an incomplete event, which happens
+   *         when the process writing the trace was killed
+   */
+  bool isTruncated() const noexcept { return truncated; }
+
+//-----------------------------------------------------------------------------
+private: // methods
+  bool getByte(unsigned char&) noexcept;
+  bool getNumber(u_int64_t&) noexcept;
+  bool getNumber(unsigned&) noexcept;
+  bool getString(std::string&);
+  bool getPlayer(std::string&);
+  bool decode(TraceEvent&);
+};
+
+} // namespace xbs
+
+#endif // XBS_EVENT_TRACE_READER_H
@@ -0,0 +1,149 @@
+//-----------------------------------------------------------------------------
+// FixedBoard.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_FIXED_BOARD_H
+#define XBS_FIXED_BOARD_H
+
+#include "Platform.h"
+#include "Movement.h"
+#include "Rectangle.h"
+#include "Ship.h"
+#include <bitset>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// The FixedBoard class template is a read-only snapshot of a ship area
+// descriptor whose width and height are known at compile time.  Index math,
+// edge tests and the square masks are sized by constants, so the compiler
+// can fold them and unroll the per-square loops.
+//
+// It answers the same per-index questions as Board (adjacentFree,
+// adjacentHits, freeCount, hitCount, maxInlineHits) with the same results.
+// Check matches() first and fall back to Board for any other geometry.
+//-----------------------------------------------------------------------------
+template<unsigned W, unsigned H>
+class FixedBoard {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum : unsigned {
+    WIDTH = W,
+    HEIGHT = H,
+    SIZE = (W * H)
+  };
+
+  static_assert(((W > 0) && (H > 0)), "FixedBoard dimensions must be > 0");
+
+//-----------------------------------------------------------------------------
+private: // variables
+  std::bitset<SIZE> free;   // Ship::NONE squares
+  std::bitset<SIZE> hits;   // Ship::HIT squares
+  std::bitset<SIZE> struck; // Ship::isHit() squares
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  FixedBoard() noexcept = default;
+  FixedBoard(FixedBoard&&) noexcept = default;
+  FixedBoard(const FixedBoard&) noexcept = default;
+  FixedBoard& operator=(FixedBoard&&) noexcept = default;
+  FixedBoard& operator=(const FixedBoard&) noexcept = default;
+
+  explicit FixedBoard(const std::string& descriptor) noexcept {
+    load(descriptor);
+  }
+
+//-----------------------------------------------------------------------------
+public: // static methods
+  static bool matches(const Rectangle& shipArea) noexcept {
+    return ((shipArea.getWidth() == W) && (shipArea.getHeight() == H));
+  }
+
+  static bool hasNeighbor(const unsigned idx, const Direction dir) noexcept {
+    switch (dir) {
+    case North: return (idx >= W);
+    case East:  return (((idx % W) + 1) < W);
+    case South: return ((idx + W) < SIZE);
+    case West:  return ((idx % W) > 0);
+    }
+    return false;
+  }
+
+  static unsigned neighbor(const unsigned idx, const Direction dir) noexcept {
+    switch (dir) {
+    case North: return (idx - W);
+    case East:  return (idx + 1);
+    case South: return (idx + W);
+    case West:  return (idx - 1);
+    }
+    return idx;
+  }
+
+//-----------------------------------------------------------------------------
+public: // methods
+  void load(const std::string& descriptor) noexcept {
+    ASSERT(descriptor.size() == SIZE);
+    for (unsigned i = 0; i < SIZE; ++i) {
+      const char ch = descriptor[i];
+      free[i] = (ch == Ship::NONE);
+      hits[i] = (ch == Ship::HIT);
+      struck[i] = Ship::isHit(ch);
+    }
+  }
+
+  const std::bitset<SIZE>& freeSquares() const noexcept { return free; }
+  const std::bitset<SIZE>& hitSquares() const noexcept { return hits; }
+
+  unsigned adjacentFree(const unsigned idx) const noexcept {
+    return adjacent(free, idx);
+  }
+
+  unsigned adjacentHits(const unsigned idx) const noexcept {
+    return adjacent(hits, idx);
+  }
+
+  unsigned freeCount(const unsigned idx, const Direction dir) const noexcept {
+    return count(free, idx, dir);
+  }
+
+  unsigned hitCount(const unsigned idx, const Direction dir) const noexcept {
+    return count(struck, idx, dir);
+  }
+
+  unsigned maxInlineHits(const unsigned idx) const noexcept {
+    return std::max(std::max(hitCount(idx, North), hitCount(idx, South)),
+                    std::max(hitCount(idx, East), hitCount(idx, West)));
+  }
+
+//-----------------------------------------------------------------------------
+private: // methods
+  static unsigned adjacent(const std::bitset<SIZE>& mask,
+                           const unsigned idx) noexcept
+  {
+    return ((hasNeighbor(idx, North) && mask[idx - W]) +
+            (hasNeighbor(idx, South) && mask[idx + W]) +
+            (hasNeighbor(idx, East) && mask[idx + 1]) +
+            (hasNeighbor(idx, West) && mask[idx - 1]));
+  }
+
+  static unsigned count(const std::bitset<SIZE>& mask,
+                        unsigned idx,
+                        const Direction dir) noexcept
+  {
+    unsigned n = 0;
+    while (hasNeighbor(idx, dir) && mask[idx = neighbor(idx, dir)]) {
+      ++n;
+    }
+    return n;
+  }
+};
+
+//-----------------------------------------------------------------------------
+// The geometry of Configuration::getDefaultConfiguration()
+//-----------------------------------------------------------------------------
+typedef FixedBoard<10, 10> StandardBoard;
+
+} // namespace xbs
+
+#endif // XBS_FIXED_BOARD_H
@@ -0,0 +1,235 @@
+//-----------------------------------------------------------------------------
+// FrameCodec.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "FrameCodec.h"
+#include "Coordinate.h"
+#include "Input.h"
+#include "Ship.h"
+#include "StringUtils.h"
+#include <cstring>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+static const char SQUARE_VALUE[4] = { Ship::NONE, Ship::MISS, Ship::HIT, 0 };
+
+//-----------------------------------------------------------------------------
+static unsigned char squareBits(const char ch) noexcept {
+  switch (ch) {
+  case Ship::NONE: return 0;
+  case Ship::MISS: return 1;
+  case Ship::HIT:  return 2;
+  }
+  return 3;
+}
+
+//-----------------------------------------------------------------------------
+static void putVarint(std::string& out, u_int64_t value) {
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+//-----------------------------------------------------------------------------
+static void putField(std::string& out, const FrameCodec::FieldTag tag,
+                     const u_int64_t value)
+{
+  putVarint(out, ((value << 2) | tag));
+}
+
+//-----------------------------------------------------------------------------
+static bool getVarint(const unsigned char*& p, const unsigned char* end,
+                      u_int64_t& value) noexcept
+{
+  value = 0;
+  for (unsigned shift = 0; (p < end) && (shift < 64); shift += 7) {
+    const unsigned char byte = (*p++);
+    value |= (static_cast<u_int64_t>(byte & 0x7F) << shift);
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+void FrameCodec::encode(const std::string& msg, std::string& frame) {
+  std::string payload;
+  payload.reserve(msg.size());
+
+  const char* begin = msg.c_str();
+  const char* end = (begin + msg.size());
+  const char* p = static_cast<const char*>(memchr(begin, '|', msg.size()));
+
+  if ((p ? (p - begin) : msg.size()) != 1) {
+    payload += static_cast<char>(RAW_TYPE);
+    encodeField(RAW_TYPE, 0, begin, end, payload);
+  } else {
+    const char type = (*begin);
+    payload += type;
+    for (unsigned index = 1; p; ++index) {
+      begin = (p + 1);
+      p = static_cast<const char*>(memchr(begin, '|', (end - begin)));
+      encodeField(type, index, begin, (p ? p : end), payload);
+    }
+  }
+
+  frame.clear();
+  frame.reserve(payload.size() + 4);
+  putVarint(frame, payload.size());
+  frame += payload;
+}
+
+//-----------------------------------------------------------------------------
+int FrameCodec::decode(const char* data, const unsigned size, std::string& msg)
+{
+  msg.clear();
+
+  u_int64_t len = 0;
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+  const unsigned char* end = (p + size);
+  if (!getVarint(p, end, len)) {
+    return (p == end) ? 0 : -1;
+  } else if (!len || (len > Input::MAX_LINE_SIZE)) {
+    return -1;
+  } else if (len > static_cast<u_int64_t>(end - p)) {
+    return 0;
+  }
+
+  end = (p + len);
+  const char type = static_cast<char>(*p++);
+  if (type != RAW_TYPE) {
+    msg += type;
+  }
+
+  u_int64_t a = 0;
+  u_int64_t b = 0;
+  while (p < end) {
+    if (type != RAW_TYPE) {
+      msg += '|';
+    }
+    if (!getVarint(p, end, a)) {
+      return -1;
+    }
+    const FieldTag tag = static_cast<FieldTag>(a & 3);
+    a >>= 2;
+    switch (tag) {
+    case StrField:
+      if (a > static_cast<u_int64_t>(end - p)) {
+        return -1;
+      }
+      msg.append(reinterpret_cast<const char*>(p), a);
+      p += a;
+      break;
+    case UIntField:
+      msg += toStr(a);
+      break;
+    case BoardField:
+      if (((a + 3) / 4) > static_cast<u_int64_t>(end - p)) {
+        return -1;
+      }
+      for (u_int64_t i = 0; i < a; ++i) {
+        const char ch = SQUARE_VALUE[(p[i / 4] >> (2 * (i % 4))) & 3];
+        if (!ch) {
+          return -1;
+        }
+        msg += ch;
+      }
+      p += ((a + 3) / 4);
+      break;
+    case CoordField:
+      if (!getVarint(p, end, b)) {
+        return -1;
+      }
+      msg += Coordinate(static_cast<unsigned>(a),
+                        static_cast<unsigned>(b)).toString();
+      break;
+    }
+  }
+
+  return static_cast<int>(p - reinterpret_cast<const unsigned char*>(data));
+}
+
+//-----------------------------------------------------------------------------
+bool FrameCodec::isBoardField(const char type, const unsigned index,
+                              const char* begin, const char* end) noexcept
+{
+  if ((type != 'B') || (index != 3) || (begin == end)) {
+    return false;
+  }
+  for (const char* p = begin; p < end; ++p) {
+    if (squareBits(*p) > 2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FrameCodec::isCoordField(const char type, const unsigned index,
+                              const char* begin, const char* end,
+                              unsigned& x, unsigned& y)
+{
+  if ((type != 'H') || (index != 3)) {
+    return false;
+  }
+  const std::string str(begin, end);
+  Coordinate coord;
+  if (coord.fromString(str) && (coord.toString() == str)) {
+    x = coord.getX();
+    y = coord.getY();
+    return true;
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+bool FrameCodec::isUIntField(const char* begin, const char* end,
+                             unsigned& value) noexcept
+{
+  const long len = (end - begin);
+  if ((len < 1) || (len > MAX_UINT_DIGITS) || ((len > 1) && (*begin == '0')))
+  {
+    return false;
+  }
+  value = 0;
+  for (const char* p = begin; p < end; ++p) {
+    if (!isdigit(static_cast<unsigned char>(*p))) {
+      return false;
+    }
+    value = ((10 * value) + (*p - '0'));
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void FrameCodec::encodeField(const char type, const unsigned index,
+                             const char* begin, const char* end,
+                             std::string& payload)
+{
+  unsigned x = 0;
+  unsigned y = 0;
+  if (isBoardField(type, index, begin, end)) {
+    const unsigned count = static_cast<unsigned>(end - begin);
+    putField(payload, BoardField, count);
+    const size_t offset = payload.size();
+    payload.append(((count + 3) / 4), 0);
+    for (unsigned i = 0; i < count; ++i) {
+      payload[offset + (i / 4)] |= (squareBits(begin[i]) << (2 * (i % 4)));
+    }
+  } else if (isCoordField(type, index, begin, end, x, y)) {
+    putField(payload, CoordField, x);
+    putVarint(payload, y);
+  } else if (isUIntField(begin, end, x)) {
+    putField(payload, UIntField, x);
+  } else {
+    putField(payload, StrField, (end - begin));
+    payload.append(begin, end);
+  }
+}
+
+} // namespace xbs
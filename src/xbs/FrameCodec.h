@@ -0,0 +1,89 @@
+//-----------------------------------------------------------------------------
+// FrameCodec.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_FRAME_CODEC_H
+#define XBS_FRAME_CODEC_H
+
+#include "Platform.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// The FrameCodec class converts pipe delimited text protocol messages to
+// and from the optional binary framing that clients may request when they
+// join a game (see "Binary Framing" in protocol.md).
+//
+// A binary frame is a varint payload length followed by the payload:
+//
+//     payload = type field field ...
+//     type    = 1 byte, the same character as the text message type
+//     field   = varint((N << 2) | tag) followed by tag specific data
+//
+//     StrField   = N is string length, followed by N bytes
+//     UIntField  = N is the value
+//     BoardField = N is square count, followed by 2 bits per square
+//     CoordField = N is X, followed by varint Y
+//
+// Decoding a frame always produces the exact text message that was encoded.
+//-----------------------------------------------------------------------------
+class FrameCodec {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum FieldTag {
+    StrField,
+    UIntField,
+    BoardField,
+    CoordField
+  };
+
+  enum {
+    RAW_TYPE = 0, // type used for messages that aren't TYPE|VALUE|... format
+    MAX_UINT_DIGITS = 9
+  };
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  FrameCodec() = delete;
+  FrameCodec(FrameCodec&&) = delete;
+  FrameCodec(const FrameCodec&) = delete;
+  FrameCodec& operator=(FrameCodec&&) = delete;
+  FrameCodec& operator=(const FrameCodec&) = delete;
+
+//-----------------------------------------------------------------------------
+public: // static methods
+  /**
+   * @brief Encode a text protocol message as a binary frame
+   * @param msg The text message, without trailing new-line
+   * @param[out] frame Cleared then populated with the encoded frame
+   */
+  static void encode(const std::string& msg, std::string& frame);
+
+  /**
+   * @brief Decode the binary frame at the beginning of the given data
+   * @param data Pointer to the first byte of the frame
+   * @param size Number of bytes available at data
+   * @param[out] msg Cleared then populated with the decoded text message
+   * @return number of bytes consumed, 0 if the frame is incomplete,
+   *         -1 if the frame is malformed
+   */
+  static int decode(const char* data, const unsigned size, std::string& msg);
+
+//-----------------------------------------------------------------------------
+private: // static methods
+  static bool isBoardField(const char type, const unsigned index,
+                           const char* begin, const char* end) noexcept;
+  static bool isCoordField(const char type, const unsigned index,
+                           const char* begin, const char* end,
+                           unsigned& x, unsigned& y);
+  static bool isUIntField(const char* begin, const char* end,
+                          unsigned& value) noexcept;
+  static void encodeField(const char type, const unsigned index,
+                          const char* begin, const char* end,
+                          std::string& payload);
+};
+
+} // namespace xbs
+
+#endif // XBS_FRAME_CODEC_H
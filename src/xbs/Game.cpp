@@ -22,6 +22,9 @@ Game& Game::clear() noexcept {
   turnCount = 0;
   config.clear();
   boards.clear();
+  handleIndex.clear();
+  nameIndex.clear();
+  prefixIndex.clear();
   return (*this);
 }
 
@@ -42,6 +45,10 @@ Game& Game::addBoard(const BoardPtr& board) {
                 << board->handle());
   }
   boards.push_back(board);
+  addToIndexes(board);
+  if (trace) {
+    trace->playerJoined(board->getName(), board->getDescriptor());
+  }
   return (*this);
 }
 
@@ -80,10 +87,9 @@ BoardPtr Game::boardAtIndex(const unsigned index) const {
 //-----------------------------------------------------------------------------
 BoardPtr Game::boardForHandle(const int handle) const {
   if (handle >= 0) {
-    for (auto& board : boards) {
-      if (board->handle() == handle) {
-        return board;
-      }
+    auto it = handleIndex.find(handle);
+    if ((it != handleIndex.end()) && (it->second->handle() == handle)) {
+      return it->second;
     }
   }
   return nullptr;
@@ -102,20 +108,29 @@ BoardPtr Game::boardForPlayer(const std::string& name, const bool exact) const {
     }
   }
 
-  BoardPtr match;
-  for (auto& board : boards) {
-    const std::string playerName = board->getName();
-    if (playerName == name) {
-      return board;
-    } else if (!exact && iEqual(playerName, name, name.size())) {
-      if (match) {
-        return nullptr;
-      } else {
-        match = board;
-      }
-    }
+  auto it = nameIndex.find(name);
+  if (it != nameIndex.end()) {
+    return it->second;
+  } else if (exact) {
+    return nullptr;
+  }
+
+  // case insensitive prefix match, must be unique
+  const std::string prefix = toLower(name);
+  auto match = prefixIndex.lower_bound(prefix);
+  if ((match == prefixIndex.end()) ||
+      match->first.compare(0, prefix.size(), prefix))
+  {
+    return nullptr;
+  }
+
+  auto next = std::next(match);
+  if ((next != prefixIndex.end()) &&
+      !next->first.compare(0, prefix.size(), prefix))
+  {
+    return nullptr;
   }
-  return match;
+  return match->second;
 }
 
 //-----------------------------------------------------------------------------
@@ -149,7 +164,7 @@ bool Game::start(const bool randomize) {
     return false;
   }
 
-  Logger::debug() << "starting game '" << getTitle() << "'";
+  XBS_LOG_DEBUG() << "starting game '" << getTitle() << "'";
 
   if (randomize) {
     std::random_shuffle(boards.begin(), boards.end());
@@ -162,6 +177,11 @@ bool Game::start(const bool randomize) {
   turnCount = 0;
 
   updateBoardToMove();
+  if (trace) {
+    trace->gameStarted(getTitle(), config.getBoardWidth(),
+                       config.getBoardHeight(), boards.size());
+    traceTurn();
+  }
   return true;
 }
 
@@ -197,11 +217,40 @@ bool Game::nextTurn() {
       ((maxScore >= config.getPointGoal()) && (minTurns >= maxTurns)))
   {
     finished = Timer::now();
+    if (trace) {
+      trace->gameFinished(turnCount);
+    }
+  } else if (trace) {
+    traceTurn();
   }
 
   return !isFinished();
 }
 
+//-----------------------------------------------------------------------------
+char Game::shoot(Board& shooter, Board& target, const Coordinate& coord) {
+  const char id = target.shootSquare(coord);
+  if (trace) {
+    trace->shotTaken(shooter.getName(), target.getName(), coord, id);
+  }
+  if (id && !Ship::isHit(id) && !Ship::isMiss(id)) {
+    shooter.incTurns();
+    if (Ship::isValidID(id)) {
+      shooter.incScore();
+    }
+  }
+  return id;
+}
+
+//-----------------------------------------------------------------------------
+void Game::skipTurn(Board& board) {
+  board.incSkips();
+  board.incTurns();
+  if (trace) {
+    trace->turnSkipped(board.getName());
+  }
+}
+
 //-----------------------------------------------------------------------------
 bool Game::setNextTurn(const std::string& name) {
   if (name.empty()) {
@@ -228,6 +277,9 @@ bool Game::setNextTurn(const std::string& name) {
 
   toMove = idx;
   updateBoardToMove();
+  if (trace) {
+    traceTurn();
+  }
   return true;
 }
 
@@ -238,8 +290,12 @@ void Game::disconnectBoard(const std::string& name, const std::string& msg) {
   }
   auto board = boardForPlayer(name, true);
   if (board) {
+    handleIndex.erase(board->handle());
     board->setStatus(msg.size() ? msg : "disconnected");
     board->disconnect();
+    if (trace) {
+      trace->playerLeft(name);
+    }
   }
 }
 
@@ -250,16 +306,42 @@ void Game::removeBoard(const std::string& name) {
   }
   for (auto it = boards.begin(); it != boards.end(); ++it) {
     if ((*it)->getName() == name) {
+      removeFromIndexes(**it);
       boards.erase(it);
+      if (trace) {
+        trace->playerLeft(name);
+      }
       break;
     }
   }
 }
 
+//-----------------------------------------------------------------------------
+Board& Game::stealConnectionFrom(Board& board, Board&& other) {
+  auto existing = boardForPlayer(board.getName(), true);
+  if (!existing || (existing.get() != &board)) {
+    throw Error(Msg() << "Game.stealConnectionFrom() " << board
+                << " is not in this game");
+  }
+
+  handleIndex.erase(board.handle());
+  board.stealConnectionFrom(std::move(other));
+  if (board.handle() >= 0) {
+    handleIndex[board.handle()] = existing;
+  }
+  if (trace) {
+    trace->playerRejoined(board.getName());
+  }
+  return board;
+}
+
 //-----------------------------------------------------------------------------
 void Game::abort() noexcept {
   if (!aborted) {
     aborted = Timer::now();
+    if (trace && started && !finished) {
+      trace->gameAborted(turnCount);
+    }
   }
 }
 
@@ -267,6 +349,9 @@ void Game::abort() noexcept {
 void Game::finish() noexcept {
   if (!finished) {
     finished = Timer::now();
+    if (trace && started && !aborted) {
+      trace->gameFinished(turnCount);
+    }
   }
 }
 
@@ -374,6 +459,41 @@ bool Game::isValid() const noexcept {
           (boards.size() <= config.getMaxPlayers()));
 }
 
+//-----------------------------------------------------------------------------
+void Game::addToIndexes(const BoardPtr& board) {
+  if (board->handle() >= 0) {
+    handleIndex[board->handle()] = board;
+  }
+  nameIndex[board->getName()] = board;
+  prefixIndex.insert(std::make_pair(toLower(board->getName()), board));
+}
+
+//-----------------------------------------------------------------------------
+void Game::removeFromIndexes(const Board& board) {
+  auto it = handleIndex.find(board.handle());
+  if ((it != handleIndex.end()) && (it->second.get() == &board)) {
+    handleIndex.erase(it);
+  }
+
+  nameIndex.erase(board.getName());
+
+  auto range = prefixIndex.equal_range(toLower(board.getName()));
+  for (auto p = range.first; p != range.second; ++p) {
+    if (p->second.get() == &board) {
+      prefixIndex.erase(p);
+      break;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Game::traceTurn() {
+  auto board = boardAtIndex(toMove);
+  if (board) {
+    trace->turnStarted(board->getName());
+  }
+}
+
 //-----------------------------------------------------------------------------
 void Game::updateBoardToMove() noexcept {
   for (unsigned i = 0; i < boards.size(); ++i) {
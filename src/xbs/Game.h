@@ -8,8 +8,10 @@
 #include "Platform.h"
 #include "Board.h"
 #include "Configuration.h"
+#include "EventTrace.h"
 #include "Timer.h"
 #include "db/Database.h"
+#include <unordered_map>
 
 namespace xbs
 {
@@ -24,7 +26,11 @@ private: // variables
   unsigned toMove = 0;
   unsigned turnCount = 0;
   Configuration config;
+  EventTrace* trace = nullptr;
   std::vector<BoardPtr> boards;
+  std::unordered_map<int, BoardPtr> handleIndex;
+  std::unordered_map<std::string, BoardPtr> nameIndex;
+  std::multimap<std::string, BoardPtr> prefixIndex; // lower case name
 
 //-----------------------------------------------------------------------------
 public: // constructors
@@ -49,6 +55,15 @@ public: // methods
   Game& setConfiguration(const Configuration&);
   Game& setTitle(const std::string&);
 
+  /**
+   * @brief Record game events to the given trace, not changed by clear()
+   * @param eventTrace The trace to record events to, nullptr = none
+   */
+  Game& setEventTrace(EventTrace* eventTrace) noexcept {
+    trace = eventTrace;
+    return (*this);
+  }
+
   BoardPtr boardAtIndex(const unsigned index) const;
   BoardPtr boardForHandle(const int handle) const;
   BoardPtr boardForPlayer(const std::string& name, const bool exact) const;
@@ -59,12 +74,26 @@ public: // methods
   bool setNextTurn(const std::string& name);
   bool start(const bool randomizeBoardOrder = false);
 
+  /**
+   * @brief Apply the shot rules: a legal shot counts as a turn for the
+   *        shooter and a hit on a ship scores a point for the shooter
+   * @param shooter The board of the player taking the shot
+   * @param target The board being shot at
+   * @param coord The square being shot at
+   * @return the value of the target square before the shot,
+   *         0 if the coordinate is illegal
+   */
+  char shoot(Board& shooter, Board& target, const Coordinate& coord);
+
   void abort() noexcept;
   void disconnectBoard(const std::string& name, const std::string& msg);
   void finish() noexcept;
   void removeBoard(const std::string& name);
   void saveResults(Database&);
   void setBoardOrder(const std::vector<std::string>& order);
+  void skipTurn(Board&);
+
+  Board& stealConnectionFrom(Board& board, Board&& other);
 
   std::string getTitle() const { return config.getName(); }
   const Configuration& getConfiguration() const noexcept { return config; }
@@ -105,6 +134,9 @@ public: // operator overloads
 //-----------------------------------------------------------------------------
 private: // methods
   bool isValid() const noexcept;
+  void addToIndexes(const BoardPtr&);
+  void removeFromIndexes(const Board&);
+  void traceTurn();
   void updateBoardToMove() noexcept;
 };
 
@@ -3,11 +3,13 @@
 // Copyright (c) 2016-2017 Shawn Chidester, All rights reserved
 //-----------------------------------------------------------------------------
 #include "Input.h"
-#include "CSVReader.h"
+#include "FrameCodec.h"
 #include "Logger.h"
 #include "Msg.h"
 #include "StringUtils.h"
 #include "Error.h"
+#include <cstring>
+#include <limits>
 #include <sys/select.h>
 
 namespace xbs
@@ -24,7 +26,7 @@ char Input::readChar(const int fd) {
     throw Error(Msg() << "Input.readChar() failed: " << toError(errno));
   }
 
-  Logger::debug() << "Received character '" << ch << "' from channel " << fd
+  XBS_LOG_DEBUG() << "Received character '" << ch << "' from channel " << fd
                   << " " << getHandleLabel(fd);
   return ch;
 }
@@ -100,10 +102,45 @@ ControlKey Input::readKey(const int fd, char& ch) {
   return KeyChar;
 }
 
+//-----------------------------------------------------------------------------
+static bool isSpace(const char ch) noexcept {
+  return isspace(static_cast<unsigned char>(ch));
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+static bool parseInt(const char* p, const char* end, T& value) noexcept {
+  bool negative = false;
+  if ((p < end) && ((*p == '+') || (std::is_signed<T>::value && (*p == '-'))))
+  {
+    negative = (*p++ == '-');
+  }
+  if (p >= end) {
+    return false;
+  }
+
+  const u_int64_t limit = negative
+      ? (static_cast<u_int64_t>(std::numeric_limits<T>::max()) + 1)
+      : static_cast<u_int64_t>(std::numeric_limits<T>::max());
+
+  u_int64_t result = 0;
+  for (; p < end; ++p) {
+    if (!isdigit(static_cast<unsigned char>(*p)) ||
+        ((result = ((10 * result) + (*p - '0'))) > limit))
+    {
+      return false;
+    }
+  }
+
+  value = negative ? static_cast<T>(-static_cast<int64_t>(result))
+                   : static_cast<T>(result);
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 bool Input::waitForData(std::set<int>& ready, const int timeout_ms) {
   ready.clear();
-  if (handles.empty()) {
+  if (!handleCount) {
     Logger::warn() << "No input handles specified to wait for";
     return false;
   }
@@ -112,13 +149,13 @@ bool Input::waitForData(std::set<int>& ready, const int timeout_ms) {
   FD_ZERO(&set);
 
   int maxFd = -1;
-  for (auto it = handles.begin(); it != handles.end(); ++it) {
-    const int fd = it->first;
-    if (fd >= 0) {
-      if (buffer.count(fd) && (pos[fd] < len[fd])) {
+  for (int fd = 0; fd < static_cast<int>(channels.size()); ++fd) {
+    const Channel& chan = channels[fd];
+    if (chan.open) {
+      if (chan.pos < chan.len) {
         ready.insert(fd);
       } else {
-        maxFd = std::max<int>(maxFd, fd);
+        maxFd = fd;
         FD_SET(fd, &set);
       }
     }
@@ -127,7 +164,7 @@ bool Input::waitForData(std::set<int>& ready, const int timeout_ms) {
   if (ready.empty() && (maxFd >= 0)) {
     struct timeval tv;
     tv.tv_sec = (timeout_ms / 1000);
-    tv.tv_usec = ((timeout_ms % 1000) * 10);
+    tv.tv_usec = ((timeout_ms % 1000) * 1000);
 
     int ret = 0;
     while (true) {
@@ -135,7 +172,7 @@ bool Input::waitForData(std::set<int>& ready, const int timeout_ms) {
                    ((timeout_ms < 0) ? nullptr : &tv));
       if (ret < 0) {
         if (errno == EINTR) {
-          Logger::debug() << "Input select interrupted";
+          XBS_LOG_DEBUG() << "Input select interrupted";
           return false;
         }
         throw Error(Msg() << "Input select failed: " << toError(errno));
@@ -143,9 +180,8 @@ bool Input::waitForData(std::set<int>& ready, const int timeout_ms) {
       break;
     }
     if (ret) {
-      for (auto it = handles.begin(); it != handles.end(); ++it) {
-        const int fd = it->first;
-        if (FD_ISSET(fd, &set)) {
+      for (int fd = 0; fd <= maxFd; ++fd) {
+        if (channels[fd].open && FD_ISSET(fd, &set)) {
           ready.insert(fd);
         }
       }
@@ -161,104 +197,97 @@ unsigned Input::readln(const int fd, const char delimeter) {
     throw Error(Msg() << "Input readln() invalid handle: " << fd);
   }
 
-  line[0] = 0;
+  line = "";
+  lineSize = 0;
   fields.clear();
-  if (buffer.find(fd) == buffer.end()) {
-    buffer[fd].resize(BUFFER_SIZE, 0);
-    pos[fd] = 0;
-    len[fd] = 0;
-  }
 
-  unsigned n = 0;
-  while (n < (BUFFER_SIZE - 1)) {
-    if (pos[fd] >= len[fd]) {
-      if (!bufferData(fd)) {
-        return 0;
-      }
-    }
-    if (!len[fd]) {
-      break;
-    } else if ((pos[fd] < len[fd]) &&
-               ((line[n++] = buffer[fd][pos[fd]++]) == '\n'))
-    {
-      break;
-    }
+  Channel& chan = getChannel(fd);
+  if (!(chan.binary ? readFrame(fd, chan) : readLine(fd, chan))) {
+    return 0;
   }
-  line[n] = 0;
 
-  if (Logger::getInstance().getLogLevel() >= Logger::DEBUG) {
-    Logger::debug() << "Received '" << trimStr(line.data())
-                    << "' from channel " << fd << " " << getHandleLabel(fd);
-  }
+  XBS_LOG_DEBUG() << "Received '" << getLine()
+                  << "' from channel " << fd << " " << chan.label;
 
   unsigned newLineCount = 0;
-  for (unsigned i = 0; i < n; ++i) {
-    if ((line[0] == '\n') || (line[0] == '\r')) {
-      newLineCount++;
-    } else {
-      break;
-    }
+  while ((newLineCount < lineSize) &&
+         ((line[newLineCount] == '\n') || (line[newLineCount] == '\r')))
+  {
+    newLineCount++;
   }
 
-  if (!line[0] || (newLineCount == n)) {
+  if (newLineCount == lineSize) {
     return 0;
   }
 
-  fields = CSVReader(line.data(), delimeter, true).readCells();
+  splitFields(delimeter);
   return fields.size();
 }
 
 //-----------------------------------------------------------------------------
 void Input::addHandle(const int handle, const std::string& label) {
   if (handle >= 0) {
-    handles[handle] = label;
-    Logger::debug() << "Added channel " << handle << " " << label;
+    Channel& chan = getChannel(handle);
+    if (!chan.open) {
+      chan.open = true;
+      chan.binary = false;
+      chan.pos = chan.len = 0;
+      handleCount++;
+    }
+    chan.label = label;
+    XBS_LOG_DEBUG() << "Added channel " << handle << " " << label;
   }
 }
 
 //-----------------------------------------------------------------------------
 void Input::removeHandle(const int handle) {
-  Logger::debug() << "Removing channel " << handle << " "
+  XBS_LOG_DEBUG() << "Removing channel " << handle << " "
                   << getHandleLabel(handle);
 
-  auto i1 = handles.find(handle);
-  if (i1 != handles.end()) {
-    handles.erase(i1);
-  }
-
-  auto i2 = buffer.find(handle);
-  if (i2 != buffer.end()) {
-    buffer.erase(i2);
-  }
-
-  auto i3 = pos.find(handle);
-  if (i3 != pos.end()) {
-    pos.erase(i3);
+  // the channel buffer is kept so views of the current line remain valid
+  if (containsHandle(handle)) {
+    Channel& chan = channels[handle];
+    chan.open = false;
+    chan.binary = false;
+    chan.pos = chan.len = 0;
+    chan.label.clear();
+    handleCount--;
   }
+}
 
-  auto i4 = len.find(handle);
-  if (i4 != len.end()) {
-    len.erase(i4);
+//-----------------------------------------------------------------------------
+void Input::setBinary(const int handle, const bool binary) {
+  if (handle >= 0) {
+    Channel& chan = getChannel(handle);
+    chan.binary = binary;
+    XBS_LOG_DEBUG() << "Binary framing " << (binary ? "enabled" : "disabled")
+                    << " on channel " << handle << " " << chan.label;
   }
 }
 
 //-----------------------------------------------------------------------------
 bool Input::containsHandle(const int handle) const {
-  return ((handle >= 0) && (handles.count(handle) > 0));
+  return ((handle >= 0) && (handle < static_cast<int>(channels.size())) &&
+          channels[handle].open);
+}
+
+//-----------------------------------------------------------------------------
+bool Input::isBinary(const int handle) const {
+  return ((handle >= 0) && (handle < static_cast<int>(channels.size())) &&
+          channels[handle].binary);
 }
 
 //-----------------------------------------------------------------------------
 std::string Input::getHandleLabel(const int handle) const {
-  auto it = handles.find(handle);
-  if (it != handles.end()) {
-    return it->second;
+  if (containsHandle(handle)) {
+    return channels[handle].label;
   }
   return std::string();
 }
 
 //-----------------------------------------------------------------------------
 unsigned Input::getHandleCount() const noexcept {
-  return handles.size();
+  return handleCount;
 }
 
 //-----------------------------------------------------------------------------
@@ -268,7 +297,15 @@ unsigned Input::getFieldCount() const noexcept {
 
 //-----------------------------------------------------------------------------
 std::string Input::getLine(const bool trim) const {
-  return trim ? trimStr(line.data()) : std::string(line.data());
+  const char* begin = line;
+  const char* end = (line + lineSize);
+  while ((end > begin) && ((end[-1] == '\n') || (trim && isSpace(end[-1])))) {
+    --end;
+  }
+  while (trim && (begin < end) && isSpace(*begin)) {
+    ++begin;
+  }
+  return std::string(begin, end);
 }
 
 //-----------------------------------------------------------------------------
@@ -276,52 +313,179 @@ std::string Input::getStr(const unsigned index,
                           const std::string& def,
                           const bool trim) const
 {
+  UNUSED(trim); // fields are trimmed by splitFields()
   if (index >= fields.size()) {
     return def;
   } else {
-    return trim ? trimStr(fields.at(index)) : fields.at(index);
+    return std::string(fields[index].data, fields[index].size);
   }
 }
 
 //-----------------------------------------------------------------------------
 int Input::getInt(const unsigned index, const int def) const {
-  const std::string str = getStr(index);
-  return isInt(str) ? toInt32(str) : def;
+  int value = def;
+  if (index < fields.size()) {
+    const Field& field = fields[index];
+    if (!parseInt(field.data, (field.data + field.size), value)) {
+      return def;
+    }
+  }
+  return value;
 }
 
 //-----------------------------------------------------------------------------
 unsigned Input::getUInt(const unsigned index, const unsigned def) const {
-  const std::string str = getStr(index);
-  return isUInt(str) ? toUInt32(str) : def;
+  unsigned value = def;
+  if (index < fields.size()) {
+    const Field& field = fields[index];
+    if (!parseInt(field.data, (field.data + field.size), value)) {
+      return def;
+    }
+  }
+  return value;
 }
 
 //-----------------------------------------------------------------------------
 double Input::getDouble(const unsigned index, const double def) const {
-  const std::string str = getStr(index);
-  return isFloat(str) ? toDouble(str) : def;
+  char str[64];
+  if ((index >= fields.size()) || (fields[index].size >= sizeof(str))) {
+    return def;
+  }
+  memcpy(str, fields[index].data, fields[index].size);
+  str[fields[index].size] = 0;
+  return isFloat(str) ? atof(str) : def;
 }
 
 //-----------------------------------------------------------------------------
-bool Input::bufferData(const int fd) {
-  pos[fd] = len[fd] = 0;
-  while (len[fd] < BUFFER_SIZE) {
-    ssize_t n = read(fd, buffer[fd].data(), BUFFER_SIZE);
+Input::Channel& Input::getChannel(const int handle) {
+  if (handle >= static_cast<int>(channels.size())) {
+    channels.resize(handle + 1);
+  }
+  Channel& chan = channels[handle];
+  if (chan.buffer.empty()) {
+    chan.buffer.resize(BUFFER_SIZE, 0);
+  }
+  return chan;
+}
+
+//-----------------------------------------------------------------------------
+bool Input::bufferData(const int fd, Channel& chan) {
+  if (chan.pos) {
+    chan.len -= chan.pos;
+    memmove(chan.buffer.data(), (chan.buffer.data() + chan.pos), chan.len);
+    chan.pos = 0;
+  }
+
+  if (chan.len >= chan.buffer.size()) {
+    if (chan.buffer.size() >= MAX_LINE_SIZE) {
+      Logger::error() << "Input line exceeds " << MAX_LINE_SIZE
+                      << " bytes on channel " << fd << " " << chan.label;
+      chan.len = 0;
+      return false;
+    }
+    chan.buffer.resize(2 * chan.buffer.size(), 0);
+  }
+
+  while (true) {
+    ssize_t n = read(fd, (chan.buffer.data() + chan.len),
+                     (chan.buffer.size() - chan.len));
     if (n < 0) {
       if (errno == EINTR) {
-        Logger::debug() << "Input read interrupted, retrying";
+        XBS_LOG_DEBUG() << "Input read interrupted, retrying";
         continue;
       } else {
         Logger::error() << "Input read failed: " << toError(errno);
         return false;
       }
-    } else if (n <= BUFFER_SIZE) {
-      len[fd] = n;
+    }
+    chan.len += static_cast<unsigned>(n);
+    break;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Input::readFrame(const int fd, Channel& chan) {
+  while (true) {
+    const int n = FrameCodec::decode((chan.buffer.data() + chan.pos),
+                                     (chan.len - chan.pos), frameLine);
+    if (n > 0) {
+      chan.pos += n;
+      if (chan.pos >= chan.len) {
+        chan.pos = chan.len = 0;
+      }
+      line = frameLine.c_str();
+      lineSize = frameLine.size();
+      return true;
+    } else if (n < 0) {
+      Logger::error() << "Invalid binary frame on channel " << fd << " "
+                      << chan.label;
+      chan.pos = chan.len = 0;
+      return false;
+    }
+
+    const unsigned available = (chan.len - chan.pos);
+    if (!bufferData(fd, chan)) {
+      return false;
+    } else if (available == chan.len) {
+      return false; // no more data available, partial frames are discarded
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool Input::readLine(const int fd, Channel& chan) {
+  unsigned scan = chan.pos;
+  unsigned end = 0;
+  while (true) {
+    const char* begin = (chan.buffer.data() + scan);
+    const char* eol = static_cast<const char*>(
+        memchr(begin, '\n', (chan.len - scan)));
+    if (eol) {
+      end = static_cast<unsigned>(eol - chan.buffer.data() + 1);
+      break;
+    }
+    scan = (chan.len - chan.pos); // bufferData() moves unread data to front
+    if (!bufferData(fd, chan)) {
+      return false;
+    }
+    if (scan == chan.len) {
+      end = chan.len; // no more data available
       break;
-    } else {
-      throw Error("Input buffer overflow!");
     }
   }
+
+  line = (chan.buffer.data() + chan.pos);
+  lineSize = (end - chan.pos);
+  if (end < chan.len) {
+    chan.pos = end;
+  } else {
+    chan.pos = chan.len = 0;
+  }
   return true;
 }
 
+//-----------------------------------------------------------------------------
+void Input::splitFields(const char delimeter) {
+  const char* p = line;
+  const char* end = (line + lineSize);
+  while (p < end) {
+    while ((p < end) && isSpace(*p)) {
+      ++p;
+    }
+    const char* begin = p;
+    while ((p < end) && (*p != delimeter)) {
+      ++p;
+    }
+    const char* last = p;
+    while ((last > begin) && isSpace(last[-1])) {
+      --last;
+    }
+    fields.push_back({ begin, static_cast<unsigned>(last - begin) });
+    if (p < end) {
+      ++p;
+    }
+  }
+}
+
 } // namespace xbs
@@ -29,22 +29,39 @@ class Input {
 //-----------------------------------------------------------------------------
 public: // enums
   enum {
-    BUFFER_SIZE = 4096
+    BUFFER_SIZE = 4096,
+    MAX_LINE_SIZE = (256 * BUFFER_SIZE)
+  };
+
+//-----------------------------------------------------------------------------
+private: // structs
+  struct Channel {
+    bool open = false;
+    bool binary = false;
+    unsigned pos = 0;
+    unsigned len = 0;
+    std::string label;
+    std::vector<char> buffer;
+  };
+
+  struct Field {
+    const char* data;
+    unsigned size;
   };
 
 //-----------------------------------------------------------------------------
 private: // variables
   char lastChar = 0;
-  std::vector<char> line;
-  std::vector<std::string> fields;
-  std::map<int, std::string> handles;
-  std::map<int, std::vector<char>> buffer;
-  std::map<int, unsigned> pos;
-  std::map<int, unsigned> len;
+  unsigned handleCount = 0;
+  unsigned lineSize = 0;
+  const char* line = "";
+  std::string frameLine;
+  std::vector<Field> fields;
+  std::vector<Channel> channels;
 
 //-----------------------------------------------------------------------------
 public: // constructors
-  Input() : line(BUFFER_SIZE, 0) { }
+  Input() { fields.reserve(32); }
   Input(Input&&) = delete;
   Input(const Input&) = delete;
   Input& operator=(Input&&) = delete;
@@ -94,9 +111,16 @@ public: // methods
    * Read data from given handle up to whichever of these comes first:
    *
    *  * the first new-line character
-   *  * (BUFFER_SIZE - 1) bytes
    *  * no more data available
    *
+   * Lines longer than BUFFER_SIZE are not split, the channel buffer grows
+   * to hold them (up to MAX_LINE_SIZE).  The line and its fields are views
+   * into the channel buffer, they remain valid until the next call to
+   * readln() for the same handle.
+   *
+   * If binary framing is enabled for the handle (see this::setBinary())
+   * one complete binary frame is read and decoded to its text form instead.
+   *
    * Then split the data into fields using the specified delimiter.
    * You can the get individual field values via:
    *
@@ -113,7 +137,9 @@ public: // methods
 
   void addHandle(const int handle, const std::string& label = "");
   void removeHandle(const int handle);
+  void setBinary(const int handle, const bool binary);
   bool containsHandle(const int handle) const;
+  bool isBinary(const int handle) const;
   unsigned getHandleCount() const noexcept;
   unsigned getFieldCount() const noexcept;
 
@@ -129,7 +155,11 @@ public: // methods
 
 //-----------------------------------------------------------------------------
 private: // methods
-  bool bufferData(const int fd);
+  Channel& getChannel(const int handle);
+  bool bufferData(const int handle, Channel&);
+  bool readFrame(const int handle, Channel&);
+  bool readLine(const int handle, Channel&);
+  void splitFields(const char delimeter);
 };
 
 } // namespace xbs
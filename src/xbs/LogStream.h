@@ -6,81 +6,120 @@
 #define XBS_LOGSTREAM_H
 
 #include "Platform.h"
+#include "LogWriter.h"
 #include <iostream>
+#include <sstream>
 
 namespace xbs
 {
 
+//-----------------------------------------------------------------------------
+// Collects one log line, the line is handed to the LogWriter when the
+// LogStream is destroyed.
 //-----------------------------------------------------------------------------
 class LogStream {
 //-----------------------------------------------------------------------------
 private: // variables
-  std::ostream* stream = nullptr;
+  bool enabled = false;
   bool print = false;
+  bool resetFormat = true; // manipulators from earlier lines not cleared yet
+  std::string line;
 
 //-----------------------------------------------------------------------------
 public: // constructors
   LogStream() noexcept = default;
-  LogStream(LogStream&&) noexcept = default;
   LogStream(const LogStream&) = delete;
-  LogStream& operator=(LogStream&&) noexcept = default;
   LogStream& operator=(const LogStream&) = delete;
 
-  explicit LogStream(std::ostream* stream,
-                     const std::string& hdr = "",
-                     const bool print = false)
-    : stream(stream),
-      print(print && (stream != &(std::cerr)))
+  LogStream(LogStream&& other) noexcept
+    : enabled(other.enabled),
+      print(other.print),
+      resetFormat(other.resetFormat),
+      line(std::move(other.line))
   {
-    if (hdr.size()) {
-      if (stream) {
-        (*stream) << hdr;
-      }
-      if (print) {
-        std::cerr << hdr;
-      }
+    other.enabled = false;
+    other.print = false;
+  }
+
+  LogStream& operator=(LogStream&& other) noexcept {
+    if (this != &other) {
+      enabled = other.enabled;
+      print = other.print;
+      resetFormat = other.resetFormat;
+      line = std::move(other.line);
+      other.enabled = false;
+      other.print = false;
     }
+    return (*this);
   }
 
+  explicit LogStream(const std::string& hdr, const bool print = false)
+    : enabled(true),
+      print(print),
+      line(hdr)
+  { }
+
 //-----------------------------------------------------------------------------
 public: // destructor
   ~LogStream() {
-    if (stream) {
-      (*stream) << std::endl;
-      stream->flush();
-    }
     if (print) {
-      std::cerr << std::endl;
+      std::cerr << line << std::endl;
+    }
+    if (enabled) {
+      LogWriter::getInstance().write(std::move(line));
     }
   }
 
 //-----------------------------------------------------------------------------
 public: // operator overloads
   LogStream& operator<<(const char* x) {
-    if (x && (*x)) {
-      if (stream) {
-        (*stream) << x;
-      }
-      if (print) {
-        std::cerr << x;
-      }
+    if (enabled && x) {
+      line += x;
+    }
+    return (*this);
+  }
+
+  LogStream& operator<<(const std::string& x) {
+    if (enabled) {
+      line += x;
+    }
+    return (*this);
+  }
+
+  LogStream& operator<<(const char x) {
+    if (enabled) {
+      line += x;
     }
     return (*this);
   }
 
   template<class T>
   LogStream& operator<<(const T& x) {
-    if (stream) {
-      (*stream) << x;
-    }
-    if (print) {
-      std::cerr << x;
+    if (enabled) {
+      std::ostringstream& ss = formatStream();
+      if (resetFormat) {
+        // the stream is shared by every line logged on this thread
+        ss.flags(std::ios_base::dec | std::ios_base::skipws);
+        ss.precision(6);
+        ss.fill(' ');
+        resetFormat = false;
+      }
+      ss.str(std::string());
+      ss << x;
+      line += ss.str();
     }
     return (*this);
   }
+
+//-----------------------------------------------------------------------------
+private: // static methods
+  static std::ostringstream& formatStream() {
+    // one stream for all value types, so manipulators apply to later values
+    static thread_local std::ostringstream ss;
+    return ss;
+  }
 };
 
 } // namespace xbs
 
 #endif // XBS_LOGSTREAM_H
-
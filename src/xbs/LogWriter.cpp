@@ -0,0 +1,250 @@
+//-----------------------------------------------------------------------------
+// LogWriter.cpp
+// Copyright (c) 2017 Shawn Chidester, All Rights Reserved.
+//-----------------------------------------------------------------------------
+#include "LogWriter.h"
+#include "StringUtils.h"
+#include <fcntl.h>
+#include <pthread.h>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+static const u_int64_t RING_MASK = (LogWriter::RING_SIZE - 1);
+static const size_t MAX_BATCH_SIZE = (64 * 1024);
+
+//-----------------------------------------------------------------------------
+static void stopAtExit() {
+  LogWriter::getInstance().stop();
+}
+
+//-----------------------------------------------------------------------------
+static void prepareFork() {
+  LogWriter::getInstance().lockForFork();
+}
+
+//-----------------------------------------------------------------------------
+static void forkedParent() {
+  LogWriter::getInstance().unlockForFork();
+}
+
+//-----------------------------------------------------------------------------
+static void forkedChild() {
+  LogWriter& writer = LogWriter::getInstance();
+  writer.unlockForFork();
+  writer.detach();
+}
+
+//-----------------------------------------------------------------------------
+LogWriter& LogWriter::getInstance() {
+  // never deleted so it can be used by anything that logs during exit
+  static LogWriter* instance = []() {
+    LogWriter* writer = new LogWriter();
+    atexit(stopAtExit);
+    pthread_atfork(prepareFork, forkedParent, forkedChild);
+    return writer;
+  }();
+  return (*instance);
+}
+
+//-----------------------------------------------------------------------------
+LogWriter::LogWriter()
+  : ring(new Slot[RING_SIZE]),
+    head(0),
+    tail(0),
+    dropped(0),
+    producers(0),
+    stopped(false),
+    fd(STDERR_FILENO)
+{
+  static_assert(((RING_SIZE & RING_MASK) == 0), "RING_SIZE not power of 2");
+  for (u_int64_t i = 0; i < RING_SIZE; ++i) {
+    ring[i].seq.store(i, std::memory_order_relaxed);
+  }
+  writer = std::thread(&LogWriter::run, this);
+}
+
+//-----------------------------------------------------------------------------
+void LogWriter::write(std::string&& line) noexcept {
+  // stop() waits for producers to reach 0 after setting stopped, so a line
+  // either goes in the ring before the final drain or is written directly
+  producers.fetch_add(1);
+  if (!stopped.load()) {
+    push(std::move(line));
+    producers.fetch_sub(1);
+    return;
+  }
+  producers.fetch_sub(1);
+
+  try {
+    line += '\n';
+    std::lock_guard<std::mutex> lock(mutex);
+    writeFully(line.data(), line.size());
+  } catch (...) {
+    ASSERT(false);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LogWriter::push(std::string&& line) noexcept {
+  // reserve a slot, each slot's sequence number tells whether it is free
+  // for the producer at the current head position
+  u_int64_t pos = head.load(std::memory_order_relaxed);
+  Slot* slot = nullptr;
+  while (true) {
+    slot = &ring[pos & RING_MASK];
+    const u_int64_t seq = slot->seq.load(std::memory_order_acquire);
+    const int64_t diff = (static_cast<int64_t>(seq) -
+                          static_cast<int64_t>(pos));
+    if (diff == 0) {
+      if (head.compare_exchange_weak(pos, (pos + 1),
+                                     std::memory_order_relaxed))
+      {
+        break;
+      }
+    } else if (diff < 0) {
+      dropped.fetch_add(1, std::memory_order_relaxed); // ring is full
+      ready.notify_one();
+      return;
+    } else {
+      pos = head.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->line = std::move(line);
+  slot->seq.store((pos + 1), std::memory_order_release);
+
+  if ((pos - tail.load(std::memory_order_relaxed)) == (RING_SIZE / 2)) {
+    ready.notify_one();
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool LogWriter::pop(std::string& out) noexcept {
+  const u_int64_t pos = tail.load(std::memory_order_relaxed);
+  Slot& slot = ring[pos & RING_MASK];
+  if (slot.seq.load(std::memory_order_acquire) != (pos + 1)) {
+    return false;
+  }
+
+  out.append(slot.line).append(1, '\n');
+  slot.line.clear();
+  slot.seq.store((pos + RING_SIZE), std::memory_order_release);
+  tail.store((pos + 1), std::memory_order_relaxed);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void LogWriter::run() noexcept {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopped.load()) {
+    ready.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL));
+    writePending();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LogWriter::writePending() noexcept {
+  try {
+    batch.clear();
+    const u_int64_t lost = dropped.exchange(0);
+    if (lost) {
+      batch += ("WARN: " + toStr(lost) + " log lines dropped\n");
+    }
+    while (pop(batch)) {
+      if (batch.size() >= MAX_BATCH_SIZE) {
+        writeFully(batch.data(), batch.size());
+        batch.clear();
+      }
+    }
+    if (batch.size()) {
+      writeFully(batch.data(), batch.size());
+    }
+  } catch (...) {
+    ASSERT(false);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LogWriter::writeFully(const char* data, size_t size) noexcept {
+  const int out = fd.load();
+  while (size) {
+    const ssize_t n = ::write(out, data, size);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return; // nowhere to report it
+    }
+    data += n;
+    size -= n;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LogWriter::drain() noexcept {
+  if (!stopped.load()) {
+    std::lock_guard<std::mutex> lock(mutex);
+    writePending();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LogWriter::stop() noexcept {
+  if (!stopped.exchange(true)) {
+    if (writer.joinable() && (writer.get_id() != std::this_thread::get_id())) {
+      ready.notify_one();
+      writer.join();
+    }
+    while (producers.load()) {
+      std::this_thread::yield(); // let in-flight lines reach the ring
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    writePending();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LogWriter::detach() noexcept {
+  // the writer thread doesn't exist in a forked child process and the mutex
+  // is only usable because the fork handlers held it, don't wait on either
+  producers.store(0);
+  stopped.store(true);
+}
+
+//-----------------------------------------------------------------------------
+bool LogWriter::setFile(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if ((path == filePath) && (path.size() || (fd == STDERR_FILENO))) {
+    return true;
+  }
+
+  writePending(); // lines queued so far belong in the current file
+
+  bool ok = true;
+  int newFd = STDERR_FILENO;
+  if (path.size()) {
+    newFd = ::open(path.c_str(), (O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC),
+                   0666);
+    if (newFd < 0) {
+      newFd = STDERR_FILENO;
+      ok = false;
+    }
+  }
+
+  const int oldFd = fd.exchange(newFd);
+  if (oldFd != STDERR_FILENO) {
+    ::close(oldFd);
+  }
+  filePath = (ok ? path : "");
+  return ok;
+}
+
+//-----------------------------------------------------------------------------
+std::string LogWriter::getFile() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return filePath;
+}
+
+} // namespace xbs
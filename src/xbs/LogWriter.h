@@ -0,0 +1,128 @@
+//-----------------------------------------------------------------------------
+// LogWriter.h
+// Copyright (c) 2017 Shawn Chidester, All Rights Reserved.
+//-----------------------------------------------------------------------------
+#ifndef XBS_LOG_WRITER_H
+#define XBS_LOG_WRITER_H
+
+#include "Platform.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// The LogWriter class writes log lines to the log file on a background
+// thread.  Any thread can add lines without locking, lines are placed in a
+// fixed size ring buffer and the writer thread writes everything in the
+// buffer with a single write every FLUSH_INTERVAL milliseconds, or sooner
+// when the buffer is half full.
+//
+// Memory use is bounded: when the ring buffer is full new lines are dropped
+// and the number of dropped lines is reported in the log when there is room
+// again.  drain() writes everything queued so far before it returns, it is
+// called automatically at exit.
+//
+// Lines logged after stop() or by a forked child process are written
+// directly to the log file because there is no writer thread to write them.
+// Every write to the log file holds the mutex, so setFile() can close the
+// old file without racing a direct writer.
+//-----------------------------------------------------------------------------
+class LogWriter {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    RING_SIZE = 4096, // must be a power of 2
+    FLUSH_INTERVAL = 100 // milliseconds
+  };
+
+//-----------------------------------------------------------------------------
+private: // structs
+  struct Slot {
+    std::atomic<u_int64_t> seq;
+    std::string line;
+  };
+
+//-----------------------------------------------------------------------------
+private: // variables
+  std::unique_ptr<Slot[]> ring;
+  std::atomic<u_int64_t> head;
+  std::atomic<u_int64_t> tail;
+  std::atomic<u_int64_t> dropped;
+  std::atomic<unsigned> producers; // write() calls that may use the ring
+  std::atomic<bool> stopped;
+  std::atomic<int> fd;
+  std::string filePath;
+  std::string batch;
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::thread writer;
+
+//-----------------------------------------------------------------------------
+private: // constructors
+  LogWriter();
+  LogWriter(LogWriter&&) = delete;
+  LogWriter(const LogWriter&) = delete;
+  LogWriter& operator=(LogWriter&&) = delete;
+  LogWriter& operator=(const LogWriter&) = delete;
+
+//-----------------------------------------------------------------------------
+public: // static methods
+  static LogWriter& getInstance();
+
+//-----------------------------------------------------------------------------
+public: // methods
+  /**
+   * @brief Queue a log line, newline is appended by the writer
+   * @param line The log line, moved into the ring buffer
+   */
+  void write(std::string&& line) noexcept;
+
+  /**
+   * @brief Write all queued lines to the log file before returning
+   */
+  void drain() noexcept;
+
+  /**
+   * @brief Drain the queue and stop the writer thread
+   * Lines added after stop() are written immediately.
+   */
+  void stop() noexcept;
+
+  /**
+   * @brief Write all new lines directly, without the writer thread
+   * Only for use in a forked child process, queued lines are discarded.
+   */
+  void detach() noexcept;
+
+  /**
+   * @brief Hold the mutex across fork() so the child gets it unlocked
+   */
+  void lockForFork() noexcept { mutex.lock(); }
+  void unlockForFork() noexcept { mutex.unlock(); }
+
+  /**
+   * @brief Send log lines to the given file
+   * @param path The log file path, empty = stderr
+   * @return false if the file could not be opened, stderr is used instead
+   */
+  bool setFile(const std::string& path);
+
+  std::string getFile();
+  u_int64_t getDropCount() const noexcept { return dropped.load(); }
+
+//-----------------------------------------------------------------------------
+private: // methods
+  void push(std::string&& line) noexcept;
+  bool pop(std::string& line) noexcept;
+  void run() noexcept;
+  void writePending() noexcept;
+  void writeFully(const char* data, size_t size) noexcept;
+};
+
+} // namespace xbs
+
+#endif // XBS_LOG_WRITER_H
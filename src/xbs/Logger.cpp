@@ -23,8 +23,7 @@ Logger::getInstance() {
 
 //-----------------------------------------------------------------------------
 Logger::Logger()
-  : logLevel(INFO),
-    stream(&std::cerr)
+  : logLevel(INFO)
 {
   const CommandArgs& args = CommandArgs::getInstance();
 
@@ -47,29 +46,16 @@ Logger::Logger()
   }
 }
 
-//-----------------------------------------------------------------------------
-Logger::~Logger() {
-  if (fileStream.is_open()) {
-    fileStream.close();
-  }
-}
-
 //-----------------------------------------------------------------------------
 Logger&
 Logger::setLogFile(const std::string& file) {
-  stream = &std::cerr;
-  logFile.clear();
-  try {
-    if (fileStream.is_open()) {
-      fileStream.close();
-    }
-    if (file.size()) {
-      fileStream.open(file.c_str(), (std::ofstream::out|std::ofstream::app));
-      stream = &fileStream;
-      logFile = file;
-    }
-  } catch (const std::exception& e) {
-    error() << "Cannot open " << file << ": " << e.what();
+  // the log file is shared by all threads
+  if (LogWriter::getInstance().setFile(file)) {
+    logFile = file;
+  } else {
+    const int err = errno;
+    logFile.clear();
+    log(ERROR, "ERROR: ") << "Cannot open " << file << ": " << toError(err);
   }
   return (*this);
 }
@@ -7,7 +7,6 @@
 
 #include "Platform.h"
 #include "LogStream.h"
-#include <fstream>
 
 namespace xbs
 {
@@ -26,8 +25,6 @@ public: // enums
 //-----------------------------------------------------------------------------
 private: // variables
   LogLevel logLevel = INFO;
-  std::ostream* stream = nullptr;
-  std::ofstream fileStream;
   std::string logFile;
 
 //-----------------------------------------------------------------------------
@@ -38,10 +35,6 @@ private: // constructors
   Logger& operator=(Logger&&) = delete;
   Logger& operator=(const Logger&) = delete;
 
-//-----------------------------------------------------------------------------
-public: // destructor
-  ~Logger();
-
 //-----------------------------------------------------------------------------
 public: // static methods
   static Logger& getInstance();
@@ -75,17 +68,45 @@ public: // methods
   std::string getLogFile() const { return logFile; }
 
   LogStream log(const std::string& hdr = "") const {
-    return LogStream(stream, hdr);
+    return LogStream(hdr);
   }
 
   LogStream log(const LogLevel level,
       const std::string& hdr = nullptr,
       const bool print = false) const
   {
-    return (logLevel >= level) ? LogStream(stream, hdr, print) : LogStream();
+    // don't print to stderr twice when stderr is the log file
+    return (logLevel >= level) ? LogStream(hdr, (print && logFile.size()))
+                               : LogStream();
   }
+
+  /**
+   * @brief Write all queued log lines before returning
+   */
+  static void drain() noexcept { LogWriter::getInstance().drain(); }
 };
 
 } // namespace xbs
 
+//-----------------------------------------------------------------------------
+// Logging macros, use these instead of Logger::debug() etc. wherever the
+// << operands aren't free to evaluate.  Nothing after the macro is evaluated
+// unless the given log level is enabled.  When XBS_NO_DEBUG_LOG is defined
+// debug messages are compiled out entirely.
+//
+// usage: XBS_LOG_DEBUG() << "value = " << expensiveToString();
+//-----------------------------------------------------------------------------
+#define XBS_LOG_IF(level, logStream) \
+  if (xbs::Logger::getInstance().getLogLevel() < (level)) { } else logStream
+
+#define XBS_LOG_ERROR() XBS_LOG_IF(xbs::Logger::ERROR, xbs::Logger::error())
+#define XBS_LOG_WARN()  XBS_LOG_IF(xbs::Logger::WARN, xbs::Logger::warn())
+#define XBS_LOG_INFO()  XBS_LOG_IF(xbs::Logger::INFO, xbs::Logger::info())
+
+#ifdef XBS_NO_DEBUG_LOG
+#define XBS_LOG_DEBUG() if (true) { } else xbs::Logger::debug()
+#else
+#define XBS_LOG_DEBUG() XBS_LOG_IF(xbs::Logger::DEBUG, xbs::Logger::debug())
+#endif
+
 #endif // XBS_LOGGER_H
@@ -13,6 +13,12 @@ namespace xbs
 
 //-----------------------------------------------------------------------------
 class Msg : public CSVWriter {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    RESERVE_SIZE = 256 // room for a board message on common board sizes
+  };
+
 //-----------------------------------------------------------------------------
 public: // constructors
   Msg(Msg&&) noexcept = default;
@@ -26,7 +32,9 @@ public: // constructors
 
   Msg(const char type)
     : CSVWriter(std::string(1, type), '|', true)
-  { }
+  {
+    reserve(RESERVE_SIZE);
+  }
 };
 
 } // namespace xbs
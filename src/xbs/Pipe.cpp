@@ -6,42 +6,115 @@
 #include "Msg.h"
 #include "StringUtils.h"
 #include "Error.h"
+#include <atomic>
 #include <csignal>
 #include <cstring>
+#include <mutex>
 #include <fcntl.h>
 
 namespace xbs {
 
 //-----------------------------------------------------------------------------
-Pipe Pipe::SELF_PIPE;
+// Signal pipes are never closed, so the signal handler can't write to a
+// closed or reused descriptor.  A slot released when its thread exits keeps
+// its pipe and is reused by the next thread that asks for one.
+//-----------------------------------------------------------------------------
+struct SignalSlot {
+  std::atomic<bool> inUse{false};
+  std::atomic<int> writeFd{-1};
+  Pipe pipe;
+  ~SignalSlot() { writeFd.store(-1); } // before pipe is closed
+};
+
+static SignalSlot signalSlots[Pipe::MAX_SIGNAL_PIPES];
 
 //-----------------------------------------------------------------------------
-static void selfPipeSignal(int sigNumber) {
+struct SignalSlotLease {
+  SignalSlot* slot = nullptr;
+  ~SignalSlotLease() {
+    if (slot) {
+      slot->inUse.store(false);
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+void Pipe::notifyAll(const int sigNumber) noexcept {
   const int eno = errno;
-  Pipe::SELF_PIPE.writeln(toStr(sigNumber));
+  char buf[NUMBER_BUFFER_SIZE + 1];
+  unsigned len = formatNumber(buf, static_cast<int64_t>(sigNumber));
+  buf[len++] = '\n';
+  for (SignalSlot& slot : signalSlots) {
+    const int fd = slot.writeFd.load();
+    if (fd >= 0) {
+      // non-blocking, a full pipe already has a wakeup pending
+      const ssize_t n = ::write(fd, buf, len);
+      UNUSED(n);
+    }
+  }
   errno = eno;
 }
 
 //-----------------------------------------------------------------------------
-void Pipe::openSelfPipe() {
-  // TODO make thread safe
-  if (!SELF_PIPE.canRead() && !SELF_PIPE.canWrite()) {
-    SELF_PIPE.open();
-
-    int fr = SELF_PIPE.fdRead;
-    int fw = SELF_PIPE.fdWrite;
-    if ((fcntl(fr, F_SETFL, fcntl(fr, F_GETFL) | O_NONBLOCK) < 0) ||
-        (fcntl(fw, F_SETFL, fcntl(fw, F_GETFL) | O_NONBLOCK) < 0))
-    {
-      throw Error(Msg() << "Pipe.openSelfPipe() fcntl failed: "
-                  << toError(errno));
-    }
+static void selfPipeSignal(int sigNumber) {
+  Pipe::notifyAll(sigNumber);
+}
 
+//-----------------------------------------------------------------------------
+static void setSignalPipeFlags(const int fd) {
+  if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0) {
+    throw Error(Msg() << "Pipe.signalPipe() fcntl failed: "
+                << toError(errno));
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Pipe::openSelfPipe() {
+  static std::once_flag installed;
+  std::call_once(installed, []() {
     signal(SIGCHLD, selfPipeSignal);
     signal(SIGALRM, selfPipeSignal);
     signal(SIGUSR1, selfPipeSignal);
     signal(SIGUSR2, selfPipeSignal);
+  });
+}
+
+//-----------------------------------------------------------------------------
+const Pipe& Pipe::signalPipe() {
+  static thread_local SignalSlotLease lease;
+  if (lease.slot) {
+    return lease.slot->pipe;
   }
+
+  for (SignalSlot& slot : signalSlots) {
+    bool expected = false;
+    if (!slot.inUse.compare_exchange_strong(expected, true)) {
+      continue;
+    }
+
+    Pipe& pipe = slot.pipe;
+    if (pipe.canRead()) {
+      char sbuf[256]; // discard signals meant for the previous thread
+      while (::read(pipe.fdRead, sbuf, sizeof(sbuf)) > 0) { }
+    } else {
+      try {
+        pipe.open();
+        setSignalPipeFlags(pipe.fdRead);
+        setSignalPipeFlags(pipe.fdWrite);
+      } catch (...) {
+        pipe.close();
+        slot.inUse.store(false);
+        throw;
+      }
+      slot.writeFd.store(pipe.fdWrite);
+    }
+
+    lease.slot = &slot;
+    return pipe;
+  }
+
+  throw Error(Msg() << "Pipe.signalPipe() more than " << MAX_SIGNAL_PIPES
+              << " threads are waiting for signals");
 }
 
 //-----------------------------------------------------------------------------
@@ -50,8 +123,10 @@ void Pipe::open() {
     throw Error("Pipe.open() already open");
   }
 
+  // close-on-exec so shell processes started by other threads don't hold
+  // this pipe open, mergeRead()/mergeWrite() clear it on the dup'd handle
   int fd[] = { -1, -1 };
-  if (::pipe(fd) < 0) {
+  if (::pipe2(fd, O_CLOEXEC) < 0) {
     throw Error(Msg() << "Pipe.open() failed: " << toError(errno));
   }
 
@@ -81,6 +156,17 @@ void Pipe::closeWrite() noexcept {
   }
 }
 
+//-----------------------------------------------------------------------------
+void Pipe::setNonBlockingRead() {
+  if (fdRead < 0) {
+    throw Error("Pipe.setNonBlockingRead() not open");
+  }
+  if (fcntl(fdRead, F_SETFL, fcntl(fdRead, F_GETFL) | O_NONBLOCK) < 0) {
+    throw Error(Msg() << "Pipe.setNonBlockingRead() fcntl failed: "
+                << toError(errno));
+  }
+}
+
 //-----------------------------------------------------------------------------
 void Pipe::mergeRead(const int fd) {
   if (fdRead < 0) {
@@ -12,6 +12,12 @@ namespace xbs
 
 //-----------------------------------------------------------------------------
 class Pipe {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    MAX_SIGNAL_PIPES = 64
+  };
+
 //-----------------------------------------------------------------------------
 private: // variables
   int fdRead = -1;
@@ -47,10 +53,26 @@ public: // destructor
   ~Pipe() noexcept { close(); }
 
 //-----------------------------------------------------------------------------
-public: // static members
-  static Pipe SELF_PIPE;
+public: // static methods
+  /**
+   * @brief Install the signal handlers that write to the signal pipes
+   */
   static void openSelfPipe();
 
+  /**
+   * @brief Get the calling thread's signal pipe, open it if necessary
+   * Every caught signal writes its number to the signal pipe of every
+   * thread, so threads waiting on their own pipe never miss a signal that
+   * another thread read first.
+   */
+  static const Pipe& signalPipe();
+
+  /**
+   * @brief Write the given signal number to every thread's signal pipe
+   * Safe to call from a signal handler.
+   */
+  static void notifyAll(const int sigNumber) noexcept;
+
 //-----------------------------------------------------------------------------
 public: // methods
   bool canRead() const noexcept { return (fdRead >= 0); }
@@ -65,6 +87,7 @@ public: // methods
   void closeWrite() noexcept;
   void mergeRead(const int fd);
   void mergeWrite(const int fd);
+  void setNonBlockingRead();
   void writeln(const std::string& = "") const;
 };
 
@@ -0,0 +1,239 @@
+//-----------------------------------------------------------------------------
+// PluginBot.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "PluginBot.h"
+#include "Error.h"
+#include "Logger.h"
+#include "Msg.h"
+#include "ShellProcess.h"
+#include "StringUtils.h"
+#include <dlfcn.h>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+PluginBot::PluginBot(const std::string& cmd)
+  : Bot("pluginBot", Version("1.0"))
+{
+  std::vector<std::string> args = ShellProcess::splitStr(cmd);
+  if (args.empty() || args[0].empty()) {
+    throw Error("Empty bot plugin command");
+  }
+
+  libraryPath = args[0];
+  library = dlopen(libraryPath.c_str(), (RTLD_NOW | RTLD_LOCAL));
+  if (!library) {
+    throw Error(Msg() << "Unable to load bot plugin '" << libraryPath
+                << "': " << dlerror());
+  }
+
+  try {
+    auto entry = reinterpret_cast<xbs_get_bot_plugin_fn>(
+        dlsym(library, XBS_BOT_PLUGIN_ENTRY));
+    if (!entry) {
+      throw Error(Msg() << "No " << XBS_BOT_PLUGIN_ENTRY
+                  << "() function in bot plugin '" << libraryPath << "'");
+    }
+
+    plugin = entry();
+    if (!plugin || (plugin->abiVersion != XBS_BOT_PLUGIN_ABI_VERSION)) {
+      throw Error(Msg() << "Incompatible bot plugin '" << libraryPath
+                  << "' ABI version " << (plugin ? plugin->abiVersion : 0));
+    }
+
+    std::vector<const char*> argv;
+    for (const std::string& arg : args) {
+      argv.push_back(arg.c_str());
+    }
+    argv.push_back(nullptr);
+
+    bot = plugin->create(static_cast<int>(args.size()), argv.data());
+    if (!bot) {
+      throw Error(Msg() << "Failed to create bot from plugin '"
+                  << libraryPath << "'");
+    }
+
+    setBotName(plugin->getBotName(bot));
+    setBotVersion(Version(plugin->getBotVersion(bot)));
+    setPlayerName(plugin->getPlayerName(bot));
+  } catch (...) {
+    close();
+    throw;
+  }
+
+  XBS_LOG_DEBUG() << "Loaded bot plugin '" << libraryPath << "': "
+                  << getBotName() << ' ' << getBotVersion();
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::close() noexcept {
+  if (bot) {
+    plugin->destroy(bot);
+    bot = nullptr;
+  }
+  plugin = nullptr;
+  if (library) {
+    dlclose(library);
+    library = nullptr;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::check(const int status, const char* function) const {
+  if (status) {
+    throw Error(Msg() << getBotName() << '.' << function << "() failed: "
+                << plugin->lastError(bot));
+  }
+}
+
+//-----------------------------------------------------------------------------
+std::string PluginBot::newGame(const Configuration& config) {
+  std::vector<xbs_ship> ships;
+  for (const Ship& ship : config) {
+    ships.push_back(xbs_ship { ship.getID(), ship.getLength() });
+  }
+
+  const std::string name = config.getName();
+  xbs_config cfg;
+  cfg.name = name.c_str();
+  cfg.minPlayers = config.getMinPlayers();
+  cfg.maxPlayers = config.getMaxPlayers();
+  cfg.pointGoal = config.getPointGoal();
+  cfg.boardWidth = config.getBoardWidth();
+  cfg.boardHeight = config.getBoardHeight();
+  cfg.shipCount = static_cast<unsigned>(ships.size());
+  cfg.ships = ships.data();
+
+  // player name and static board may have been changed by the host
+  check(plugin->setPlayerName(bot, getPlayerName().c_str()), "setPlayerName");
+  check(plugin->setStaticBoard(bot, getStaticBoard().c_str()),
+        "setStaticBoard");
+
+  const char* desc = nullptr;
+  check(plugin->newGame(bot, &cfg, &desc), "newGame");
+  return desc ? desc : "";
+}
+
+//-----------------------------------------------------------------------------
+std::string PluginBot::getBestShot(Coordinate& bestShot) {
+  const char* target = nullptr;
+  unsigned x = 0;
+  unsigned y = 0;
+  check(plugin->getBestShot(bot, &target, &x, &y), "getBestShot");
+  if (!target || !(*target)) {
+    bestShot.clear();
+    return "";
+  }
+  bestShot.set(x, y);
+  return target;
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::playerJoined(const std::string& player) {
+  check(plugin->playerJoined(bot, player.c_str()), "playerJoined");
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::startGame(const std::vector<std::string>& playerOrder) {
+  std::vector<const char*> players;
+  for (const std::string& player : playerOrder) {
+    players.push_back(player.c_str());
+  }
+  check(plugin->startGame(bot, players.data(),
+                          static_cast<unsigned>(players.size())),
+        "startGame");
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::finishGame(const std::string& state,
+                           const unsigned turnCount,
+                           const unsigned playerCount)
+{
+  check(plugin->finishGame(bot, state.c_str(), turnCount, playerCount),
+        "finishGame");
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::playerResult(const std::string& player,
+                             const unsigned score,
+                             const unsigned skips,
+                             const unsigned turns,
+                             const std::string& status)
+{
+  check(plugin->playerResult(bot, player.c_str(), score, skips, turns,
+                             status.c_str()),
+        "playerResult");
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::updateBoard(const std::string& player,
+                            const std::string& status,
+                            const std::string& boardDescriptor,
+                            const unsigned score,
+                            const unsigned skips,
+                            const unsigned turns)
+{
+  check(plugin->updateBoard(bot, player.c_str(), status.c_str(),
+                            boardDescriptor.c_str(), score, skips, turns),
+        "updateBoard");
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::updateSquares(const std::string& player,
+                              const std::string& status,
+                              const SquareUpdates& squares,
+                              const unsigned score,
+                              const unsigned skips)
+{
+  std::vector<unsigned> indexes;
+  std::string values;
+  indexes.reserve(squares.size());
+  values.reserve(squares.size());
+  for (const auto& square : squares) {
+    indexes.push_back(square.first);
+    values += square.second;
+  }
+  check(plugin->updateSquares(bot, player.c_str(), status.c_str(),
+                              indexes.data(), values.data(),
+                              static_cast<unsigned>(indexes.size()),
+                              score, skips),
+        "updateSquares");
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::skipPlayerTurn(const std::string& player,
+                               const std::string& reason)
+{
+  check(plugin->skipPlayerTurn(bot, player.c_str(), reason.c_str()),
+        "skipPlayerTurn");
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::updatePlayerToMove(const std::string& player) {
+  check(plugin->updatePlayerToMove(bot, player.c_str()),
+        "updatePlayerToMove");
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::messageFrom(const std::string& from,
+                            const std::string& message,
+                            const std::string& group)
+{
+  check(plugin->messageFrom(bot, from.c_str(), message.c_str(),
+                            group.c_str()),
+        "messageFrom");
+}
+
+//-----------------------------------------------------------------------------
+void PluginBot::hitScored(const std::string& player,
+                          const std::string& target,
+                          const Coordinate& hitCoordinate)
+{
+  check(plugin->hitScored(bot, player.c_str(), target.c_str(),
+                          hitCoordinate.getX(), hitCoordinate.getY()),
+        "hitScored");
+}
+
+} // namespace xbs
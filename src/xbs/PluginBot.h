@@ -0,0 +1,88 @@
+//-----------------------------------------------------------------------------
+// PluginBot.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_PLUGIN_BOT_H
+#define XBS_PLUGIN_BOT_H
+
+#include "Platform.h"
+#include "Bot.h"
+#include "BotPlugin.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// The PluginBot class runs a bot that is loaded from a shared library with
+// dlopen().  All Bot methods are forwarded to the plugin in-process, so
+// there is no process or protocol overhead between host and bot.
+//-----------------------------------------------------------------------------
+class PluginBot : public Bot {
+//-----------------------------------------------------------------------------
+private: // variables
+  std::string libraryPath;
+  void* library = nullptr;
+  const xbs_bot_plugin* plugin = nullptr;
+  void* bot = nullptr;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  explicit PluginBot(const std::string& pluginCommand);
+  PluginBot() = delete;
+  PluginBot(PluginBot&&) = delete;
+  PluginBot(const PluginBot&) = delete;
+  PluginBot& operator=(PluginBot&&) = delete;
+  PluginBot& operator=(const PluginBot&) = delete;
+
+//-----------------------------------------------------------------------------
+public: // destructor
+  virtual ~PluginBot() noexcept { close(); }
+
+//-----------------------------------------------------------------------------
+public: // Bot implementation
+  std::string newGame(const Configuration& gameConfig) override;
+  std::string getBestShot(Coordinate&) override;
+  void playerJoined(const std::string& player) override;
+  void startGame(const std::vector<std::string>& playerOrder) override;
+  void finishGame(const std::string& state,
+                  const unsigned turnCount,
+                  const unsigned playerCount) override;
+  void playerResult(const std::string& player,
+                    const unsigned score,
+                    const unsigned skips,
+                    const unsigned turns,
+                    const std::string& status) override;
+  void updateBoard(const std::string& player,
+                   const std::string& status,
+                   const std::string& boardDescriptor,
+                   const unsigned score,
+                   const unsigned skips,
+                   const unsigned turns = ~0U) override;
+  void updateSquares(const std::string& player,
+                     const std::string& status,
+                     const SquareUpdates& squares,
+                     const unsigned score,
+                     const unsigned skips) override;
+  void skipPlayerTurn(const std::string& player,
+                      const std::string& reason) override;
+  void updatePlayerToMove(const std::string& player) override;
+  void messageFrom(const std::string& from,
+                   const std::string& msg,
+                   const std::string& group) override;
+  void hitScored(const std::string& player,
+                 const std::string& target,
+                 const Coordinate& hitCoordinate) override;
+
+//-----------------------------------------------------------------------------
+public: // methods
+  std::string getLibraryPath() const { return libraryPath; }
+
+//-----------------------------------------------------------------------------
+private: // methods
+  void check(const int status, const char* function) const;
+  void close() noexcept;
+};
+
+} // namespace xbs
+
+#endif // XBS_PLUGIN_BOT_H
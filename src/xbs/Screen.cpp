@@ -15,6 +15,10 @@ namespace xbs
 //-----------------------------------------------------------------------------
 static std::unique_ptr<Screen> instance;
 
+//-----------------------------------------------------------------------------
+const Screen::Cell Screen::BLANK = { ' ', DefaultColor };
+const Screen::Cell Screen::UNKNOWN = { 0, DefaultColor };
+
 //-----------------------------------------------------------------------------
 static Rectangle GetScreenDimensions() {
   struct winsize max;
@@ -36,12 +40,28 @@ static Rectangle GetScreenDimensions() {
 
 //-----------------------------------------------------------------------------
 Screen& Screen::get(const bool update) {
-  if (update || !instance) {
+  if (!instance) {
     instance.reset(new Screen(GetScreenDimensions()));
+  } else if (update) {
+    // may be called from a signal handler, so don't touch the cell buffers
+    const Rectangle dimensions = GetScreenDimensions();
+    if ((dimensions.getWidth() != instance->getWidth()) ||
+        (dimensions.getHeight() != instance->getHeight()))
+    {
+      static_cast<Rectangle&>(*instance) = dimensions;
+      instance->resized = 1;
+    }
   }
   return (*instance);
 }
 
+//-----------------------------------------------------------------------------
+Screen::~Screen() noexcept {
+  try {
+    flush();
+  } catch (...) { }
+}
+
 //-----------------------------------------------------------------------------
 const char* Screen::colorCode(const ScreenColor color) {
   switch (color) {
@@ -60,37 +80,77 @@ const char* Screen::colorCode(const ScreenColor color) {
 
 //-----------------------------------------------------------------------------
 Screen& Screen::clear() {
-  return str("\033[2J");
+  if (!buffered) {
+    beginBuffering();
+  }
+  updateGrid();
+  blank(0, back.size());
+  clearPending = true; // also erases anything written around the screen
+  return (*this);
 }
 
 //-----------------------------------------------------------------------------
 Screen& Screen::clearLine() {
-  return str("\033[2K");
+  if (!buffered) {
+    return str("\033[2K");
+  }
+  updateGrid();
+  const unsigned row = ((curY - 1) * gridWidth);
+  blank(row, (row + gridWidth));
+  return (*this);
 }
 
 //-----------------------------------------------------------------------------
 Screen& Screen::clearToLineBegin() {
-  return str("\033[1K");
+  if (!buffered) {
+    return str("\033[1K");
+  }
+  updateGrid();
+  const unsigned row = ((curY - 1) * gridWidth);
+  blank(row, (row + std::min(curX, gridWidth)));
+  return (*this);
 }
 
 //-----------------------------------------------------------------------------
 Screen& Screen::clearToLineEnd() {
-  return str("\033[0K");
+  if (!buffered) {
+    return str("\033[0K");
+  }
+  updateGrid();
+  const unsigned row = ((curY - 1) * gridWidth);
+  blank((row + std::min(curX, gridWidth) - 1), (row + gridWidth));
+  return (*this);
 }
 
 //-----------------------------------------------------------------------------
 Screen& Screen::clearToScreenBegin() {
-  return str("\033[1J");
+  if (!buffered) {
+    return str("\033[1J");
+  }
+  updateGrid();
+  blank(0, (((curY - 1) * gridWidth) + std::min(curX, gridWidth)));
+  return (*this);
 }
 
 //-----------------------------------------------------------------------------
 Screen& Screen::clearToScreenEnd() {
-  return str("\033[0J");
+  if (!buffered) {
+    return str("\033[0J");
+  }
+  updateGrid();
+  blank((((curY - 1) * gridWidth) + std::min(curX, gridWidth) - 1),
+        back.size());
+  return (*this);
 }
 
 //-----------------------------------------------------------------------------
 Screen& Screen::color(const ScreenColor color) {
-  return str(colorCode(color));
+  curColor = color;
+  if (!buffered) {
+    str(colorCode(color));
+    termColor = color;
+  }
+  return (*this);
 }
 
 //-----------------------------------------------------------------------------
@@ -100,11 +160,17 @@ Screen& Screen::cursor(const Coordinate& coord) {
 
 //-----------------------------------------------------------------------------
 Screen& Screen::cursor(const unsigned x, const unsigned y) {
+  if (!buffered) {
+    beginBuffering();
+  }
+  updateGrid();
   if (!contains(x, y)) {
     Logger::error() << "invalid screen coordinates: " << x << ',' << y;
     return (*this);
   }
-  return str("\033[" + toStr(y) + ';' + toStr(x) + 'H');
+  curX = x;
+  curY = y;
+  return (*this);
 }
 
 //-----------------------------------------------------------------------------
@@ -129,12 +195,98 @@ Screen& Screen::flush() {
   if (fflush(stdout)) {
     throw Error(Msg() << "Screen flush failed: " << toError(errno));
   }
+  if (!buffered) {
+    return (*this);
+  }
+
+  updateGrid();
+  if (clearPending) {
+    clearPending = false;
+    out += colorCode(DefaultColor);
+    out += "\033[2J";
+    termColor = DefaultColor;
+    termX = termY = 0;
+    front.assign(back.size(), BLANK);
+  }
+
+  for (unsigned y = 1; y <= gridHeight; ++y) {
+    const unsigned row = ((y - 1) * gridWidth);
+    unsigned last = gridWidth; // cells after last are blank
+    while (last && (back[row + last - 1] == BLANK)) {
+      last--;
+    }
+    for (unsigned x = 1; x <= gridWidth; ++x) {
+      const unsigned i = (row + x - 1);
+      if (back[i] == front[i]) {
+        continue;
+      }
+      if (x > last) {
+        moveTo(x, y);
+        setColor(DefaultColor);
+        out += "\033[0K";
+        std::fill((front.begin() + i), (front.begin() + row + gridWidth),
+                  BLANK);
+        break;
+      }
+      moveTo(x, y);
+      setColor(back[i].color);
+      out += back[i].ch;
+      front[i] = back[i];
+      termX = (x < gridWidth) ? (x + 1) : 0; // 0 = pending line wrap
+    }
+  }
+
+  moveTo(std::min(curX, gridWidth), curY);
+  setColor(curColor);
+  writeOut();
   return (*this);
 }
 
+//-----------------------------------------------------------------------------
+Screen& Screen::invalidate() {
+  if (buffered) {
+    clearPending = true;
+  }
+  return (*this);
+}
+
+//-----------------------------------------------------------------------------
+Screen& Screen::echoed() {
+  if (buffered) {
+    updateGrid();
+    if (curY < gridHeight) {
+      std::fill((front.begin() + ((curY - 1) * gridWidth)), front.end(),
+                UNKNOWN);
+    } else {
+      clearPending = true; // the terminal scrolled
+    }
+    newLine();
+    termX = termY = 0;
+  }
+  return (*this);
+}
+
+//-----------------------------------------------------------------------------
+u_int64_t Screen::getClearStamp(const unsigned top, const unsigned bottom) {
+  if (!buffered) {
+    return clearCount;
+  }
+  updateGrid();
+  u_int64_t stamp = 0;
+  for (unsigned y = std::max(1U, top); y <= std::min(bottom, gridHeight); ++y) {
+    stamp = std::max(stamp, rowStamps[y - 1]);
+  }
+  return stamp;
+}
+
 //-----------------------------------------------------------------------------
 Screen& Screen::str(const std::string& x) {
-  if (fwrite(x.c_str(), x.size(), 1, stdout) < 0) {
+  if (buffered) {
+    updateGrid();
+    for (const char c : x) {
+      put(c);
+    }
+  } else if (fwrite(x.c_str(), x.size(), 1, stdout) < 0) {
     throw Error(Msg() << "Failed to print to screen: " << toError(errno));
   }
   return (*this);
@@ -142,10 +294,156 @@ Screen& Screen::str(const std::string& x) {
 
 //-----------------------------------------------------------------------------
 Screen& Screen::ch(const char x) {
-  if (x && (fputc(x, stdout) != x)) {
+  if (buffered) {
+    updateGrid();
+    put(x);
+  } else if (x && (fputc(x, stdout) != x)) {
     throw Error(Msg() << "Failed to print to screen: " << toError(errno));
   }
   return (*this);
 }
 
+//-----------------------------------------------------------------------------
+void Screen::beginBuffering() {
+  buffered = true;
+  curX = 1;
+  curY = 1;
+  back.clear();
+  updateGrid();
+}
+
+//-----------------------------------------------------------------------------
+void Screen::blank(const unsigned begin, const unsigned end) {
+  const unsigned last = std::min<unsigned>(end, back.size());
+  if (begin < last) {
+    std::fill((back.begin() + begin), (back.begin() + last), BLANK);
+    ++clearCount;
+    for (unsigned y = (begin / gridWidth); y <= ((last - 1) / gridWidth); ++y) {
+      rowStamps[y] = clearCount;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Screen::moveTo(const unsigned x, const unsigned y) {
+  if ((termY == y) && (termX == x)) {
+    return;
+  }
+
+  if ((termY == y) && termX && (x > termX) && ((x - termX) <= 4)) {
+    // rewriting a few unchanged cells is shorter than a cursor escape
+    bool sameColor = true;
+    for (unsigned i = termX; sameColor && (i < x); ++i) {
+      sameColor = (cell(i, y).color == termColor);
+    }
+    if (sameColor) {
+      for (unsigned i = termX; i < x; ++i) {
+        out += cell(i, y).ch;
+      }
+      termX = x;
+      return;
+    }
+  }
+
+  if ((x == 1) && termY && ((y == termY) || (y == (termY + 1)))) {
+    out += (y == termY) ? "\r" : "\r\n";
+  } else {
+    out += ("\033[" + toStr(y) + ';' + toStr(x) + 'H');
+  }
+  termX = x;
+  termY = y;
+}
+
+//-----------------------------------------------------------------------------
+void Screen::newLine() {
+  curX = 1;
+  if (curY < gridHeight) {
+    curY++;
+  } else {
+    // scroll up one line, same as the terminal would
+    std::copy((back.begin() + gridWidth), back.end(), back.begin());
+    blank((back.size() - gridWidth), back.size());
+    rowStamps.assign(gridHeight, clearCount);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Screen::put(const char x) {
+  switch (x) {
+  case '\n':
+    newLine();
+    return;
+  case '\r':
+    curX = 1;
+    return;
+  case '\t':
+    do {
+      put(' ');
+    } while ((curX - 1) % 8);
+    return;
+  default:
+    if (static_cast<unsigned char>(x) < ' ') {
+      return;
+    }
+    break;
+  }
+
+  if (curX > gridWidth) {
+    newLine();
+  }
+  cell(curX++, curY) = Cell { x, curColor };
+}
+
+//-----------------------------------------------------------------------------
+void Screen::setColor(const ScreenColor color) {
+  if (termColor != color) {
+    out += colorCode(color);
+    termColor = color;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Screen::updateGrid() {
+  if (resized || back.empty()) {
+    resized = 0;
+    const unsigned width = std::max<unsigned>(1, getWidth());
+    const unsigned height = std::max<unsigned>(1, getHeight());
+    std::vector<Cell> grid((width * height), BLANK);
+    for (unsigned y = 0; y < std::min(height, gridHeight); ++y) {
+      for (unsigned x = 0; x < std::min(width, gridWidth); ++x) {
+        grid[(y * width) + x] = back[(y * gridWidth) + x];
+      }
+    }
+
+    back.swap(grid);
+    front.assign(back.size(), UNKNOWN);
+    rowStamps.assign(height, ++clearCount);
+    gridWidth = width;
+    gridHeight = height;
+    curX = std::min(curX, width);
+    curY = std::min(curY, height);
+    clearPending = true;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Screen::writeOut() {
+  const char* data = out.data();
+  size_t remain = out.size();
+  while (remain) {
+    const ssize_t n = ::write(STDOUT_FILENO, data, remain);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      const int err = errno;
+      out.clear();
+      throw Error(Msg() << "Failed to print to screen: " << toError(err));
+    }
+    data += n;
+    remain -= static_cast<size_t>(n);
+  }
+  out.clear();
+}
+
 } // namespace xbs
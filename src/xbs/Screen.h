@@ -9,6 +9,7 @@
 #include "Rectangle.h"
 #include "Coordinate.h"
 #include "Printable.h"
+#include <csignal>
 
 namespace xbs
 {
@@ -37,8 +38,55 @@ enum ScreenFlag {
   ClearToScreenEnd
 };
 
+//-----------------------------------------------------------------------------
+// The Screen class draws into a back buffer of character cells and flush()
+// sends only the cells that differ from what is already on the terminal
+// (the front buffer) to stdout, with a single write.
+//
+// Output is passed straight through to the terminal until the first clear()
+// or cursor() call, so help text and other line oriented output behaves as
+// usual.  After that the cell buffers are in use.
 //-----------------------------------------------------------------------------
 class Screen : public Rectangle {
+//-----------------------------------------------------------------------------
+private: // structs
+  struct Cell {
+    char ch;
+    ScreenColor color;
+
+    bool operator==(const Cell& other) const noexcept {
+      return ((ch == other.ch) && (color == other.color));
+    }
+
+    bool operator!=(const Cell& other) const noexcept {
+      return !operator==(other);
+    }
+  };
+
+//-----------------------------------------------------------------------------
+private: // static constants
+  static const Cell BLANK;
+  static const Cell UNKNOWN;
+
+//-----------------------------------------------------------------------------
+private: // variables
+  bool buffered = false;
+  bool clearPending = false;
+  volatile sig_atomic_t resized = 0;
+  unsigned gridWidth = 0;
+  unsigned gridHeight = 0;
+  unsigned curX = 1;
+  unsigned curY = 1;
+  unsigned termX = 0; // 0 = unknown
+  unsigned termY = 0;
+  ScreenColor curColor = DefaultColor;
+  ScreenColor termColor = DefaultColor;
+  u_int64_t clearCount = 0;
+  std::vector<u_int64_t> rowStamps; // clearCount when each row was cleared
+  std::vector<Cell> back;
+  std::vector<Cell> front;
+  std::string out;
+
 //-----------------------------------------------------------------------------
 private: // constructors
   Screen() = delete;
@@ -51,6 +99,10 @@ private: // constructors
     : Rectangle(container)
   { }
 
+//-----------------------------------------------------------------------------
+public: // destructor
+  ~Screen() noexcept;
+
 //-----------------------------------------------------------------------------
 public: // static methods
   static Screen& get(const bool update = false);
@@ -73,6 +125,32 @@ public: // methods
   Screen& flush();
   Screen& str(const std::string&);
 
+  /**
+   * @brief Forget what is on the terminal, the next flush repaints it all
+   */
+  Screen& invalidate();
+
+  /**
+   * @brief Tell the screen a line of input was echoed by the terminal at the
+   *        cursor, the echoed row and the rows below it are repainted by the
+   *        next flush and the cursor moves to the next line
+   */
+  Screen& echoed();
+
+  /**
+   * @return true if the terminal size changed since the last screen update
+   */
+  bool isResized() const noexcept { return resized; }
+
+  /**
+   * @brief Get a stamp that changes whenever any of the given rows is
+   *        cleared or scrolled, so callers that draw incrementally know
+   *        when to draw everything again
+   * @param top The first row (inclusive)
+   * @param bottom The last row (inclusive)
+   */
+  u_int64_t getClearStamp(const unsigned top, const unsigned bottom);
+
   Screen& operator<<(const ScreenColor x) { return color(x); }
   Screen& operator<<(const ScreenFlag x) { return flag(x); }
   Screen& operator<<(const Coordinate& x) { return cursor(x); }
@@ -84,15 +162,30 @@ public: // methods
 //-----------------------------------------------------------------------------
 public: // operator overloads
   Screen& operator<<(const double x) {
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(2) << x;
-    return str(ss.str());
+    std::string s;
+    appendNumber(s, x, 2);
+    return str(s);
   }
 
   template<typename T>
   Screen& operator<<(const T& x) {
     return str(toStr(x));
   }
+
+//-----------------------------------------------------------------------------
+private: // methods
+  Cell& cell(const unsigned x, const unsigned y) {
+    return back[((y - 1) * gridWidth) + (x - 1)];
+  }
+
+  void beginBuffering();
+  void blank(const unsigned begin, const unsigned end);
+  void moveTo(const unsigned x, const unsigned y);
+  void newLine();
+  void put(const char);
+  void setColor(const ScreenColor);
+  void updateGrid();
+  void writeOut();
 };
 
 } // namespace xbs
@@ -8,11 +8,16 @@
 #include "CSVWriter.h"
 #include "Logger.h"
 #include "Msg.h"
+#include "Pipe.h"
 #include "Screen.h"
 #include "StringUtils.h"
 #include "Error.h"
 #include "db/FileSysDatabase.h"
 #include "db/FileSysDBRecord.h"
+#include "db/LogDatabase.h"
+#include <csignal>
+#include <iostream>
+#include <sstream>
 
 namespace xbs
 {
@@ -25,6 +30,7 @@ const std::string COMM_ERROR("comm error");
 const std::string GAME_ABORTED("game aborted");
 const std::string GAME_FULL("game is full");
 const std::string GAME_STARETD("game is already started");
+const std::string IDLE_TIMEOUT("idle timeout");
 const std::string INVALID_BOARD("invalid board");
 const std::string INVALID_NAME("E|invalid name");
 const std::string NAME_IN_USE("E|name in use");
@@ -32,62 +38,147 @@ const std::string NAME_TOO_LONG("E|name too long");
 const std::string PLAYER_EXITED("exited");
 const std::string PLAYER_PREFIX("Player: ");
 const std::string PROTOCOL_ERROR("protocol error");
+const std::string SPECTATORS_FULL("too many spectators");
+const std::string TURN_TIMEOUT("turn timeout");
+
+//-----------------------------------------------------------------------------
+const std::string Server::BINARY_OPTION("binary");
+const std::string Server::DELTA_OPTION("delta");
+const std::string Server::PING_OPTION("ping");
 
 //-----------------------------------------------------------------------------
 Version Server::getVersion() {
   return SERVER_VERSION;
 }
 
+//-----------------------------------------------------------------------------
+static volatile sig_atomic_t shutdownRequested = 0;
+
+//-----------------------------------------------------------------------------
+void Server::requestShutdown() noexcept {
+  shutdownRequested = 1;
+}
+
+//-----------------------------------------------------------------------------
+bool Server::isShutdownRequested() noexcept {
+  return (shutdownRequested != 0);
+}
+
 //-----------------------------------------------------------------------------
 void Server::showHelp() {
   const std::string progname = CommandArgs::getInstance().getProgramName();
-  Screen::print()
-      << EL
-      << "usage: " << progname << " [OPTIONS]" << EL
-      << EL
-      << "GENERAL OPTIONS:" << EL
-      << "  --help                    Show help and exit" << EL
-      << "  -l, --log-level <level>   Set log level: DEBUG, INFO, WARN, ERROR " << EL
-      << "  -f, --log-file <file>     Write log messages to given file" << EL
-      << "  -q, --quiet               No screen updates during game" << EL
-      << EL
-      << "CONNECTION OPTIONS:" << EL
-      << "  -b, --bind-address <addr> Bind server to given IP address" << EL
-      << "  -p, --port <port>         Listen for connections on given port" << EL
-      << EL
-      << "BOARD OPTIONS:" << EL
-      << "  -c, --config <file>       Use given board configuration file" << EL
-      << "  --width <count>           Set board width" << EL
-      << "  --height <count>          Set board height" << EL
-      << EL
-      << "GAME OPTIONS:" << EL
-      << "  -t, --title <title>       Set game title to given value" << EL
-      << "  -a, --auto-start          Auto start game if max players joined" << EL
-      << "  -r, --repeat              Repeat game when done" << EL
-      << "  --min <players>           Set minimum number of players" << EL
-      << "  --max <players>           Set maximum number of players" << EL
-      << EL
-      << "DATABASE OPTIONS:" << EL
-      << "  -d, --db-dir <dir>        Save game stats to given directory" << EL
-      << EL << Flush;
+  std::ostringstream help;
+  help
+      << '\n'
+      << "usage: " << progname << " [OPTIONS]" << '\n'
+      << '\n'
+      << "GENERAL OPTIONS:" << '\n'
+      << "  --help                    Show help and exit" << '\n'
+      << "  -l, --log-level <level>   Set log level: DEBUG, INFO, WARN, ERROR " << '\n'
+      << "  -f, --log-file <file>     Write log messages to given file" << '\n'
+      << "  -q, --quiet               No screen updates during game" << '\n'
+      << "  --headless                No terminal I/O, auto start at min players"
+      << " and repeat" << '\n'
+      << '\n'
+      << "CONNECTION OPTIONS:" << '\n'
+      << "  -b, --bind-address <addr> Bind server to given IP address" << '\n'
+      << "  -p, --port <port>         Listen for connections on given port" << '\n'
+      << "  --idle-timeout <secs>     Disconnect clients that don't join in time" << '\n'
+      << "  --ping-interval <secs>    Send keepalive to clients that request it" << '\n'
+      << '\n'
+      << "BOARD OPTIONS:" << '\n'
+      << "  -c, --config <file>       Use given board configuration file" << '\n'
+      << "  --width <count>           Set board width" << '\n'
+      << "  --height <count>          Set board height" << '\n'
+      << '\n'
+      << "GAME OPTIONS:" << '\n'
+      << "  -t, --title <title>       Set game title to given value" << '\n'
+      << "  -a, --auto-start          Auto start game if max players joined" << '\n'
+      << "  -r, --repeat              Repeat game when done" << '\n'
+      << "  --min <players>           Set minimum number of players" << '\n'
+      << "  --max <players>           Set maximum number of players" << '\n'
+      << "  --max-spectators <count>  Set maximum number of spectators" << '\n'
+      << "  --turn-timeout <secs>     Skip turns that take too long, 0 = never" << '\n'
+      << "  --trace <file>            Record game events to given trace file" << '\n'
+      << '\n'
+      << "DATABASE OPTIONS:" << '\n'
+      << "  -d, --db-dir <dir>        Save game stats to given directory" << '\n'
+      << "  --db-flush <msecs>        Delay for batching stats writes, default: "
+      << DEFAULT_DB_FLUSH_INTERVAL << '\n'
+      << "  --db-log <file>           Save game stats to given log database" << '\n'
+      << '\n';
+
+  // a headless server may have no terminal for Screen to print to
+  if (headless) {
+    std::cout << help.str() << std::flush;
+  } else {
+    Screen::print() << help.str() << Flush;
+  }
 }
 
 //-----------------------------------------------------------------------------
 bool Server::init() {
   const CommandArgs& args = CommandArgs::getInstance();
 
-  Screen::get() << args.getProgramName() << " version " << getVersion()
-                << EL << Flush;
+  headless = args.has("--headless");
+  if (headless) {
+    Logger::info() << args.getProgramName() << " version " << getVersion()
+                   << " running headless";
+    input.removeHandle(STDIN_FILENO);
+  } else {
+    Screen::get() << args.getProgramName() << " version " << getVersion()
+                  << EL << Flush;
+  }
 
   if (args.has("--help")) {
     showHelp();
     return false;
   }
 
+  if (headless && args.getStrAfter({"-t", "--title"}).empty()) {
+    Logger::printError() << "--headless requires a game title (-t)";
+    return false;
+  }
+
+  if (headless) {
+    // a shutdown signal writes to this pipe, so it can't slip in between
+    // the isShutdownRequested() check and waiting for input
+    signalHandle = Pipe::signalPipe().getReadHandle();
+    input.addHandle(signalHandle, "signals");
+  }
+
   quietMode = args.has({"-q", "--quiet"});
   autoStart = args.has({"-a", "--auto-start"});
   repeat    = args.has({"-r", "--repeat"});
 
+  maxSpectators = args.getUIntAfter("--max-spectators",
+                                    DEFAULT_MAX_SPECTATORS);
+
+  turnTimeout  = (Timer::ONE_SECOND * args.getUIntAfter("--turn-timeout"));
+  idleTimeout  = (Timer::ONE_SECOND *
+                  args.getUIntAfter("--idle-timeout", DEFAULT_IDLE_TIMEOUT));
+  pingInterval = (Timer::ONE_SECOND *
+                  args.getUIntAfter("--ping-interval", DEFAULT_PING_INTERVAL));
+
+  const std::string dbLog = args.getStrAfter("--db-log");
+  if (dbLog.size()) {
+    std::unique_ptr<LogDatabase> logDB(new LogDatabase());
+    logDB->open(dbLog);
+    db = std::move(logDB);
+  } else {
+    std::unique_ptr<FileSysDatabase> fileDB(new FileSysDatabase());
+    fileDB->open(args.getStrAfter({"-d", "--db-dir"}));
+    fileDB->setFlushInterval(args.getUIntAfter("--db-flush",
+                                               DEFAULT_DB_FLUSH_INTERVAL));
+    db = std::move(fileDB);
+  }
+
+  const std::string traceFile = args.getStrAfter("--trace");
+  if (traceFile.size()) {
+    trace.open(traceFile);
+    game.setEventTrace(&trace);
+  }
+
   game.clear();
   return true;
 }
@@ -96,6 +187,9 @@ bool Server::init() {
 bool Server::run() {
   Configuration config = newGameConfig();
   if (!config) {
+    if (headless) {
+      throw Error("Invalid game configuration"); // would fail every game
+    }
     return false;
   }
 
@@ -106,32 +200,21 @@ bool Server::run() {
 
   game.clear().setConfiguration(config).setTitle(title);
   startListening(config.getMaxPlayers() + 2);
+  if (pingInterval > 0) {
+    pingTimer = timers.schedule(pingInterval, PingTimer);
+  }
 
   bool ok = true;
   try {
-    CanonicalMode cmode(false);
-    UNUSED(cmode);
-
-    Coordinate coord;
-    Coordinate quietCoord;
-
-    while (ok && !game.isFinished()) {
-      if (!quietMode || !quietCoord) {
-        printGameInfo(coord.set(1, 1));
-        printPlayers(coord);
-        printOptions(coord);
-      }
-      if (quietMode && !quietCoord && game.isStarted() && !game.isFinished()) {
-        quietCoord.set(coord);
-      }
-      if (waitForInput()) {
-        ok = handleUserInput(coord);
-        quietCoord.clear();
+    if (headless) {
+      while (!game.isFinished() && !isShutdownRequested()) {
+        waitForInput();
       }
+      ok = game.isFinished();
+    } else {
+      ok = runInteractive();
     }
 
-    printGameInfo(coord.set(1, 1));
-    printPlayers(coord);
     if (!ok) {
       sendToAll(GAME_ABORTED);
       if (game.isStarted()) {
@@ -150,7 +233,48 @@ bool Server::run() {
 
   close();
 
-  Screen::get(true) << EL << DefaultColor << Flush;
+  if (!headless) {
+    Screen::get(true) << EL << DefaultColor << Flush;
+  }
+  return ok;
+}
+
+//-----------------------------------------------------------------------------
+bool Server::runInteractive() {
+  CanonicalMode cmode(false);
+  UNUSED(cmode);
+
+  Coordinate coord;
+  Coordinate quietCoord;
+
+  // redraw at most once per frame, however many events were handled
+  bool ok = true;
+  bool userInput = false;
+  while (ok && !game.isFinished()) {
+    if (dirty && (userInput || !frameWait())) {
+      dirty = false;
+      frameTimer.tick();
+      if (!quietMode || !quietCoord) {
+        printGameInfo(coord.set(1, 1));
+        printPlayers(coord);
+        printOptions(coord);
+      }
+      if (quietMode && !quietCoord && game.isStarted() && !game.isFinished()) {
+        quietCoord.set(coord);
+      }
+    }
+    if (userInput) {
+      ok = handleUserInput(coord);
+      quietCoord.clear();
+      dirty = true;
+    }
+    if (ok && !game.isFinished()) {
+      userInput = waitForInput(frameWait());
+    }
+  }
+
+  printGameInfo(coord.set(1, 1));
+  printPlayers(coord);
   return ok;
 }
 
@@ -182,7 +306,7 @@ Configuration Server::newGameConfig() {
     if (val < 2) {
       throw Error(Msg() << "Invalid --min value: " << str);
     } else {
-      config.setMaxPlayers(val);
+      config.setMinPlayers(val);
     }
   }
 
@@ -247,6 +371,11 @@ bool Server::isServerHandle(const int handle) const {
   return ((handle >= 0) && (handle == socket.getHandle()));
 }
 
+//-----------------------------------------------------------------------------
+bool Server::isSpectatorHandle(const int handle) const {
+  return ((handle >= 0) && spectators.count(handle));
+}
+
 //-----------------------------------------------------------------------------
 bool Server::isUserHandle(const int handle) const {
   return ((handle >= 0) && (handle == STDIN_FILENO));
@@ -263,14 +392,19 @@ bool Server::isValidPlayerName(const std::string& name) const {
       !containsAny(name, "<>[]{}()"));
 }
 
+//-----------------------------------------------------------------------------
+std::string Server::boardInfo(const Board& board) const {
+  return (Msg('B')
+          << board.getName()
+          << board.getStatus()
+          << board.maskedDescriptor()
+          << board.getScore()
+          << board.getSkips()).release();
+}
+
 //-----------------------------------------------------------------------------
 bool Server::sendBoard(Board& recipient, const Board& board) {
-  return send(recipient, Msg('B')
-              << board.getName()
-              << board.getStatus()
-              << board.maskedDescriptor()
-              << board.getScore()
-              << board.getSkips());
+  return send(recipient, boardInfo(board));
 }
 
 //-----------------------------------------------------------------------------
@@ -319,30 +453,67 @@ bool Server::send(Board& recipient, const std::string& msg,
 
 //-----------------------------------------------------------------------------
 bool Server::waitForInput(const int timeout) {
+  // don't wait past the next timer
+  int waitTime = timeout;
+  const int timerWait = timers.timeout();
+  if ((timerWait >= 0) && ((waitTime < 0) || (timerWait < waitTime))) {
+    waitTime = timerWait;
+  }
+
+  // don't wait indefinitely while spectators have unsent messages
+  for (auto& pair : spectators) {
+    if (pair.second->hasQueuedMessages()) {
+      if ((waitTime < 0) || (waitTime > SPECTATOR_FLUSH_INTERVAL)) {
+        waitTime = SPECTATOR_FLUSH_INTERVAL;
+      }
+      break;
+    }
+  }
+
   std::set<int> ready;
-  if (!input.waitForData(ready, timeout)) {
+  if (!input.waitForData(ready, waitTime)) {
+    handleTimers();
+    flushSpectators();
     return false;
   }
 
+  dirty = true;
   bool userInput = false;
   for (const int handle : ready) {
-    if (isServerHandle(handle)) {
+    if (handle == signalHandle) {
+      char sbuf[64];
+      while (::read(handle, sbuf, sizeof(sbuf)) > 0) { }
+    } else if (isServerHandle(handle)) {
       addPlayerHandle();
     } else if (isUserHandle(handle)) {
       userInput = true;
+    } else if (isSpectatorHandle(handle)) {
+      handleSpectatorInput(handle);
     } else {
       handlePlayerInput(handle);
     }
   }
+
+  handleTimers();
+  flushSpectators();
   return userInput;
 }
 
+//-----------------------------------------------------------------------------
+int Server::frameWait() const noexcept {
+  if (!dirty) {
+    return -1;
+  }
+  const Milliseconds elapsed = frameTimer.tock();
+  return (elapsed < FRAME_INTERVAL) ? int(FRAME_INTERVAL - elapsed) : 0;
+}
+
 //-----------------------------------------------------------------------------
 void Server::addPlayerHandle() {
   const Configuration& config = game.getConfiguration();
   auto board = std::make_shared<Board>("new", config, socket.accept());
   if (!board->isConnected()) {
-    Logger::debug() << "no new connetion from accept"; // not an error
+    XBS_LOG_DEBUG() << "no new connetion from accept"; // not an error
     return;
   }
 
@@ -351,13 +522,19 @@ void Server::addPlayerHandle() {
   }
 
   if (blackList.count(ADDRESS_PREFIX + board->getAddress())) {
-    Logger::debug() << (*board) << " address is blacklisted";
+    XBS_LOG_DEBUG() << (*board) << " address is blacklisted";
     return;
   }
 
-  if (sendGameInfo(*board) && game.hasOpenBoard()) {
+  if (sendGameInfo(*board) &&
+      (game.hasOpenBoard() || (spectators.size() < maxSpectators)))
+  {
     input.addHandle(board->handle(), board->getAddress());
     newBoards[board->handle()] = board;
+    if (idleTimeout > 0) {
+      idleTimers[board->handle()] =
+          timers.schedule(idleTimeout, IdleTimer, board->handle());
+    }
   }
 }
 
@@ -439,10 +616,41 @@ void Server::close() {
   }
   newBoards.clear();
 
+  for (auto& pair : spectators) {
+    pair.second->flush(); // best effort, don't wait for slow spectators
+    input.removeHandle(pair.first);
+    pair.second->disconnect();
+  }
+  spectators.clear();
+
+  timers.clear();
+  idleTimers.clear();
+  turnTimer = 0;
+  pingTimer = 0;
+
   if (socket) {
     input.removeHandle(socket.getHandle());
     socket.close();
   }
+
+  if (db) {
+    db->flush();
+  }
+
+  trace.flush();
+}
+
+//-----------------------------------------------------------------------------
+void Server::flushSpectators() {
+  std::vector<SpectatorPtr> failed;
+  for (auto& pair : spectators) {
+    if (!pair.second->flush()) {
+      failed.push_back(pair.second);
+    }
+  }
+  for (auto& spectator : failed) {
+    removeSpectator(*spectator, COMM_ERROR);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -473,17 +681,91 @@ void Server::handlePlayerInput(const int handle) {
     case 'P': ping(*board);         return;
     case 'S': shoot(*board);        return;
     case 'T': setTaunt(*board);     return;
+    case 'W': watchGame(board);     return;
     default:
       break;
     }
   }
 
-  Logger::debug() << "Invalid message(" << input.getLine() << ") from "
+  XBS_LOG_DEBUG() << "Invalid message(" << input.getLine() << ") from "
                   << (*board);
 
   send((*board), PROTOCOL_ERROR);
 }
 
+//-----------------------------------------------------------------------------
+void Server::handleTimers() {
+  std::vector<TimerWheel::Event> expired;
+  if (!timers.advance(expired)) {
+    return;
+  }
+
+  dirty = true;
+  for (const TimerWheel::Event& event : expired) {
+    switch (event.type) {
+    case TurnTimer:
+      if (event.id == turnTimer) {
+        turnTimer = 0;
+        auto toMove = game.boardToMove();
+        if (toMove && game.isStarted() && !game.isFinished()) {
+          Logger::info() << (*toMove) << " " << TURN_TIMEOUT;
+          skipPlayer((*toMove), TURN_TIMEOUT);
+        }
+      }
+      break;
+    case IdleTimer:
+      idleTimers.erase(event.value);
+      if (newBoards.count(event.value)) {
+        auto board = newBoards[event.value];
+        Logger::info() << (*board) << " " << IDLE_TIMEOUT;
+        removePlayer((*board), IDLE_TIMEOUT);
+      }
+      break;
+    case PingTimer:
+      if (event.id == pingTimer) {
+        sendKeepAlive();
+        pingTimer = timers.schedule(pingInterval, PingTimer);
+      }
+      break;
+    default:
+      throw Error(Msg() << "Unknown timer type: " << event.type);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Server::handleSpectatorInput(const int handle) {
+  auto it = spectators.find(handle);
+  if (it == spectators.end()) {
+    throw Error(Msg() << "Unknown spectator handle: " << handle);
+  }
+
+  auto spectator = it->second;
+  if (!input.readln(handle)) {
+    Logger::warn() << "Disconnecting " << (*spectator);
+    removeSpectator(*spectator);
+    return;
+  }
+
+  // spectators may only ping or leave
+  std::string str = input.getStr();
+  if (str == "L") {
+    removeSpectator(*spectator);
+    return;
+  } else if (str == "P") {
+    std::string msg = input.getLine(false);
+    if (msg.length()) {
+      spectator->send(msg);
+      return;
+    }
+  }
+
+  XBS_LOG_DEBUG() << "Invalid message(" << input.getLine() << ") from "
+                  << (*spectator);
+
+  spectator->send(PROTOCOL_ERROR);
+}
+
 //-----------------------------------------------------------------------------
 bool Server::handleUserInput(Coordinate coord) {
   char ch = 0;
@@ -505,6 +787,50 @@ bool Server::handleUserInput(Coordinate coord) {
   return true;
 }
 
+//-----------------------------------------------------------------------------
+std::vector<std::string> Server::getJoinOptions() const {
+  std::vector<std::string> options;
+  for (unsigned i = 3; i < input.getFieldCount(); ++i) {
+    const std::string option = input.getStr(i);
+    if (((option == BINARY_OPTION) || (option == DELTA_OPTION) ||
+         (option == PING_OPTION)) &&
+        (std::find(options.begin(), options.end(), option) == options.end()))
+    {
+      options.push_back(option);
+    }
+  }
+  return options;
+}
+
+//-----------------------------------------------------------------------------
+bool Server::confirmJoin(Board& joiner,
+                         const std::vector<std::string>& options)
+{
+  CSVWriter joinMsg = Msg('J') << joiner.getName();
+  for (const std::string& option : options) {
+    joinMsg << option;
+  }
+
+  if (!send(joiner, joinMsg)) {
+    return false;
+  }
+
+  // negotiated options take effect after the confirmation message
+  joiner.setDeltaUpdates(false);
+  joiner.setKeepAlive(false);
+  for (const std::string& option : options) {
+    if (option == BINARY_OPTION) {
+      joiner.setBinary(true);
+      input.setBinary(joiner.handle(), true);
+    } else if (option == DELTA_OPTION) {
+      joiner.setDeltaUpdates(true);
+    } else if (option == PING_OPTION) {
+      joiner.setKeepAlive(true);
+    }
+  }
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 void Server::joinGame(BoardPtr& joiner) {
   if (!joiner) {
@@ -514,6 +840,7 @@ void Server::joinGame(BoardPtr& joiner) {
   const Configuration& config = game.getConfiguration();
   const std::string playerName = input.getStr(1);
   const std::string shipDescriptor = input.getStr(2);
+  const std::vector<std::string> options = getJoinOptions();
 
   if (game.hasBoard(joiner->handle())) {
     throw Error(Msg() << "duplicate handle (" << joiner->handle()
@@ -534,7 +861,9 @@ void Server::joinGame(BoardPtr& joiner) {
       if (existingBoard->isConnected()) {
         send((*joiner), NAME_IN_USE);
       } else {
-        rejoinGame(existingBoard->stealConnectionFrom(std::move(*joiner)));
+        rejoinGame(game.stealConnectionFrom((*existingBoard),
+                                            std::move(*joiner)),
+                   options);
       }
     } else {
       removePlayer((*joiner), GAME_STARETD);
@@ -551,8 +880,9 @@ void Server::joinGame(BoardPtr& joiner) {
     game.addBoard(joiner);
 
     // send confirmation to joining board
-    CSVWriter joinMsg = Msg('J') << playerName;
-    send((*joiner), joinMsg);
+    if (!confirmJoin((*joiner), options)) {
+      return;
+    }
 
     // send name of other players to joining board
     for (auto& board : game.getBoards()) {
@@ -564,6 +894,7 @@ void Server::joinGame(BoardPtr& joiner) {
     }
 
     // let other players know playerName has joined
+    CSVWriter joinMsg = Msg('J') << playerName;
     for (auto& recipient : game.getBoards()) {
       if (recipient->isConnected() &&
           (recipient->handle() != joiner->handle()))
@@ -571,10 +902,13 @@ void Server::joinGame(BoardPtr& joiner) {
         send((*recipient), joinMsg);
       }
     }
+    sendToSpectators(joinMsg);
 
     // start the game if max player count reached and autoStart enabled
-    if (autoStart && !game.isStarted() &&
-        (game.getBoardCount() == config.getMaxPlayers()) &&
+    // headless servers start as soon as min player count is reached
+    if (!game.isStarted() &&
+        ((autoStart && (game.getBoardCount() == config.getMaxPlayers())) ||
+         (headless && (game.getBoardCount() >= config.getMinPlayers()))) &&
         game.start(true))
     {
       sendStart();
@@ -594,6 +928,7 @@ void Server::nextTurn() {
     auto toMove = game.boardToMove();
     if (toMove) {
       sendToAll(Msg('N') << toMove->getName());
+      startTurnTimer();
     } else {
       throw Error("Failed to get board to move");
     }
@@ -644,6 +979,10 @@ void Server::printPlayers(Coordinate& coord) {
                   << "Players Joined : " << game.getBoardCount()
                   << (game.isStarted() ? " (In Progress)" : " (Not Started)");
 
+  if (spectators.size()) {
+    Screen::print() << ", Spectators : " << spectators.size();
+  }
+
   coord.south().setX(3);
 
   int n = 0;
@@ -671,13 +1010,14 @@ bool Server::quitGame(Coordinate coord) {
 }
 
 //-----------------------------------------------------------------------------
-void Server::rejoinGame(Board& joiner) {
+void Server::rejoinGame(Board& joiner,
+                        const std::vector<std::string>& options)
+{
   removeNewBoard(joiner.handle());
   joiner.setStatus("");
 
   // send confirmation and yourboard info to rejoining player
-  if (!send(joiner, Msg('J') << joiner.getName()) ||
-      !sendYourBoard(joiner))
+  if (!confirmJoin(joiner, options) || !sendYourBoard(joiner))
   {
     return;
   }
@@ -714,6 +1054,9 @@ void Server::rejoinGame(Board& joiner) {
       sendBoard((*recipient), joiner);
     }
   }
+  for (auto& pair : spectators) {
+    pair.second->sendBoard(joiner.getName(), boardInfo(joiner));
+  }
 
   // send message to all that rejoining player player has reconnected
   sendToAll(Msg('M') << "" << (joiner.getName() + " reconnected"));
@@ -725,6 +1068,12 @@ void Server::removeNewBoard(const int handle) {
   if (it != newBoards.end()) {
     newBoards.erase(it);
   }
+
+  auto timer = idleTimers.find(handle);
+  if (timer != idleTimers.end()) {
+    timers.cancel(timer->second);
+    idleTimers.erase(timer);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -740,7 +1089,7 @@ void Server::removePlayer(Board& board, const std::string& msg) {
     if (game.hasBoard(board.handle()) || game.hasBoard(board.getName())) {
       throw Error(Msg() << board << " in game boards and new boards array");
     }
-    newBoards.erase(it);
+    removeNewBoard(board.handle());
     return;
   }
 
@@ -761,24 +1110,93 @@ void Server::removePlayer(Board& board, const std::string& msg) {
       }
     }
   }
+
+  if (!game.isStarted()) {
+    sendToSpectators(Msg('L') << board.getName() << msg);
+  } else if (spectators.size()) {
+    const std::string info = boardInfo(board);
+    for (auto& pair : spectators) {
+      pair.second->sendBoard(board.getName(), info);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Server::removeSpectator(Spectator& spectator, const std::string& msg) {
+  const int handle = spectator.handle();
+  input.removeHandle(handle);
+
+  if (msg.size() && (msg != COMM_ERROR)) {
+    spectator.send(msg);
+    spectator.flush();
+  }
+
+  spectator.disconnect();
+  spectators.erase(handle);
 }
 
 //-----------------------------------------------------------------------------
 void Server::saveResult() {
-  if (game.isStarted() && game.isFinished()) {
-    const CommandArgs& args = CommandArgs::getInstance();
-    FileSysDatabase db;
-    db.open(args.getStrAfter({"-d", "--db-dir"}));
-    game.saveResults(db);
-    db.sync();
+  if (db && game.isStarted() && game.isFinished()) {
+    game.saveResults(*db);
+    db->sync();
   }
 }
 
 //-----------------------------------------------------------------------------
 void Server::sendBoardToAll(const Board& board) {
+  const std::string msg = boardInfo(board);
   for (auto& recipient : game.getBoards()) {
     if (recipient->isConnected()) {
-      sendBoard((*recipient), board);
+      send((*recipient), msg);
+    }
+  }
+  for (auto& pair : spectators) {
+    pair.second->sendBoard(board.getName(), msg);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Server::sendBoardUpdate(Board& board,
+                             const std::vector<unsigned>& squares)
+{
+  // periodically send the full board to everyone
+  if (!(board.incUpdates() % FULL_BOARD_INTERVAL)) {
+    sendBoardToAll(board);
+    return;
+  }
+
+  CSVWriter deltaMsg = Msg('D')
+      << board.getName()
+      << board.getStatus()
+      << board.getScore()
+      << board.getSkips();
+
+  for (const unsigned idx : squares) {
+    deltaMsg << idx << Ship::mask(board.getSquare(idx));
+  }
+
+  std::string msg;
+  for (auto& recipient : game.getBoards()) {
+    if (!recipient->isConnected()) {
+      continue;
+    } else if (recipient->wantsDeltaUpdates()) {
+      send((*recipient), deltaMsg);
+    } else {
+      if (msg.empty()) {
+        msg = boardInfo(board);
+      }
+      send((*recipient), msg);
+    }
+  }
+
+  // spectators always get full boards so queued boards can be replaced
+  if (spectators.size()) {
+    if (msg.empty()) {
+      msg = boardInfo(board);
+    }
+    for (auto& pair : spectators) {
+      pair.second->sendBoard(board.getName(), msg);
     }
   }
 }
@@ -797,6 +1215,7 @@ void Server::sendGameResults() {
       send((*recipient), finishMessage);
     }
   }
+  sendToSpectators(finishMessage);
 
   // sort boards by score, descending
   std::stable_sort(boards.begin(), boards.end(),
@@ -805,16 +1224,19 @@ void Server::sendGameResults() {
     }
   );
 
-  // send sorted result messages to all boards (N x N)
-  for (auto& recipient : boards) {
-    for (auto& board : boards) {
-      send((*recipient), Msg('R')
-           << board->getName()
-           << board->getScore()
-           << board->getSkips()
-           << board->getTurns()
-           << board->getStatus());
+  // send sorted result messages to all boards (N x N) and spectators
+  for (auto& board : boards) {
+    const std::string resultMsg = (Msg('R')
+        << board->getName()
+        << board->getScore()
+        << board->getSkips()
+        << board->getTurns()
+        << board->getStatus()).toString();
+
+    for (auto& recipient : boards) {
+      send((*recipient), resultMsg);
     }
+    sendToSpectators(resultMsg);
   }
 
   // disconnect all boards
@@ -823,6 +1245,16 @@ void Server::sendGameResults() {
   }
 }
 
+//-----------------------------------------------------------------------------
+void Server::sendKeepAlive() {
+  const std::string msg = (Msg('P') << Timer::now()).toString();
+  for (auto& recipient : game.getBoards()) {
+    if (recipient->isConnected() && recipient->wantsKeepAlive()) {
+      send((*recipient), msg);
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 void Server::sendMessage(Board& sender) {
   // TODO blacklist sender if too many messages too rapidly
@@ -889,6 +1321,9 @@ void Server::sendStart() {
       send((*recipient), nextTurnMsg);
     }
   }
+  sendToSpectators(startMsg);
+  sendToSpectators(nextTurnMsg);
+  startTurnTimer();
 }
 
 //-----------------------------------------------------------------------------
@@ -898,6 +1333,14 @@ void Server::sendToAll(const std::string& msg) {
       send((*recipient), msg);
     }
   }
+  sendToSpectators(msg);
+}
+
+//-----------------------------------------------------------------------------
+void Server::sendToSpectators(const std::string& msg) {
+  for (auto& pair : spectators) {
+    pair.second->send(msg);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -948,24 +1391,22 @@ void Server::shoot(Board& shooter) {
   }
 
   Coordinate coord(input.getUInt(2), input.getUInt(3));
-  const char id = target->shootSquare(coord);
+  const char id = game.shoot(shooter, (*target), coord);
   if (!id) {
     send(shooter, "M||illegal coordinates");
   } else if (Ship::isHit(id) || Ship::isMiss(id)) {
     send(shooter, "M||that spot has already been shot");
   } else {
-    shooter.incTurns();
     if (Ship::isValidID(id)) {
-      shooter.incScore();
       sendToAll(Msg('H') << shooter.getName() << target->getName() << coord);
       if (target->hasHitTaunts()) {
         send(shooter, Msg('M') << target->getName() << target->nextHitTaunt());
       }
-      sendBoardToAll(shooter);
+      sendBoardUpdate(shooter, { });
     } else if (target->hasMissTaunts()) {
       send(shooter, Msg('M') << target->getName() << target->nextMissTaunt());
     }
-    sendBoardToAll(*target);
+    sendBoardUpdate((*target), { target->getShipIndex(coord) });
     nextTurn();
   }
 }
@@ -982,14 +1423,18 @@ void Server::skipBoard(Coordinate coord) {
   if (iStartsWith(str, 'Y')) {
     str = prompt(coord, "Enter reason [RET=Abort] -> ");
     if (str.size()) {
-      toMove->incSkips();
-      toMove->incTurns();
-      sendToAll(Msg('K') << toMove->getName() << str);
-      nextTurn();
+      skipPlayer((*toMove), str);
     }
   }
 }
 
+//-----------------------------------------------------------------------------
+void Server::skipPlayer(Board& board, const std::string& reason) {
+  game.skipTurn(board);
+  sendToAll(Msg('K') << board.getName() << reason);
+  nextTurn();
+}
+
 //-----------------------------------------------------------------------------
 void Server::skipTurn(Board& board) {
   if (!game.isStarted()) {
@@ -1006,8 +1451,7 @@ void Server::skipTurn(Board& board) {
   } else if (board.getName() != toMove->getName()) {
     send(board, "M||it is not your turn!");
   } else {
-    board.incSkips();
-    board.incTurns();
+    game.skipTurn(board);
     nextTurn();
   }
 }
@@ -1032,4 +1476,78 @@ void Server::startListening(const int backlog) {
   input.addHandle(socket.getHandle());
 }
 
+//-----------------------------------------------------------------------------
+void Server::startTurnTimer() {
+  if (turnTimer) {
+    timers.cancel(turnTimer);
+    turnTimer = 0;
+  }
+  if (turnTimeout > 0) {
+    turnTimer = timers.schedule(turnTimeout, TurnTimer);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Server::watchGame(BoardPtr& watcher) {
+  if (!watcher) {
+    throw Error("Server.watchGame() null board");
+  }
+
+  const std::string name = input.getStr(1);
+  const std::vector<std::string> options = getJoinOptions();
+
+  if (game.hasBoard(watcher->handle())) {
+    throw Error(Msg() << "duplicate handle (" << watcher->handle()
+                << ") in watch command!");
+  } else if (name.empty()) {
+    removePlayer((*watcher), PROTOCOL_ERROR);
+  } else if (blackList.count(PLAYER_PREFIX + name)) {
+    removePlayer((*watcher), BOOTED);
+  } else if (spectators.size() >= maxSpectators) {
+    removePlayer((*watcher), SPECTATORS_FULL);
+  } else if (!isValidPlayerName(name)) {
+    send((*watcher), INVALID_NAME);
+  } else {
+    const int handle = watcher->handle();
+    auto spectator = std::make_shared<Spectator>(
+        name, watcher->releaseConnection());
+
+    removeNewBoard(handle);
+    spectators[handle] = spectator;
+
+    // send confirmation, binary option takes effect after the confirmation
+    const bool binary = (std::find(options.begin(), options.end(),
+                                   BINARY_OPTION) != options.end());
+    CSVWriter watchMsg = Msg('W') << name;
+    if (binary) {
+      watchMsg << BINARY_OPTION;
+    }
+
+    spectator->send(watchMsg);
+    if (binary) {
+      spectator->setBinary(true);
+      input.setBinary(handle, true);
+    }
+
+    // send current state of the game to the new spectator
+    CSVWriter startMsg = Msg('S');
+    for (auto& board : game.getBoards()) {
+      spectator->send(Msg('J') << board->getName());
+      startMsg << board->getName();
+    }
+
+    if (game.isStarted()) {
+      for (auto& board : game.getBoards()) {
+        spectator->sendBoard(board->getName(), boardInfo(*board));
+      }
+      spectator->send(startMsg);
+
+      auto toMove = game.boardToMove();
+      if (toMove) {
+        spectator->send(Msg('N') << toMove->getName());
+      }
+    }
+  }
+}
+
 } // namespace xbs
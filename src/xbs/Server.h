@@ -8,10 +8,15 @@
 #include "Platform.h"
 #include "Board.h"
 #include "Configuration.h"
+#include "EventTrace.h"
 #include "Game.h"
 #include "Input.h"
+#include "Spectator.h"
 #include "TcpSocket.h"
+#include "Timer.h"
+#include "TimerWheel.h"
 #include "Version.h"
+#include "db/Database.h"
 
 namespace xbs
 {
@@ -21,19 +26,55 @@ class Server {
 //-----------------------------------------------------------------------------
 public: // enums
   enum {
-    DEFAULT_PORT = 7948
+    DEFAULT_PORT = 7948,
+    DEFAULT_IDLE_TIMEOUT = 300, // seconds
+    DEFAULT_MAX_SPECTATORS = 8,
+    DEFAULT_PING_INTERVAL = 30, // seconds
+    DEFAULT_DB_FLUSH_INTERVAL = 1000, // milliseconds
+    FULL_BOARD_INTERVAL = 16,
+    FRAME_INTERVAL = 33, // milliseconds, redraw at most 30 times per second
+    SPECTATOR_FLUSH_INTERVAL = 50 // milliseconds
   };
 
+//-----------------------------------------------------------------------------
+private: // enums
+  enum TimerType {
+    TurnTimer,
+    IdleTimer,
+    PingTimer
+  };
+
+//-----------------------------------------------------------------------------
+public: // join options
+  static const std::string BINARY_OPTION;
+  static const std::string DELTA_OPTION;
+  static const std::string PING_OPTION;
+
 //-----------------------------------------------------------------------------
 private: // variables
+  bool headless = false;
   bool quietMode = false;
   bool autoStart = false;
   bool repeat = false;
+  bool dirty = true; // screen needs to be redrawn
+  unsigned maxSpectators = DEFAULT_MAX_SPECTATORS;
+  unsigned turnTimer = 0;
+  unsigned pingTimer = 0;
+  int signalHandle = -1; // wakes a headless server for shutdown
+  Milliseconds turnTimeout = 0;
+  Milliseconds idleTimeout = 0;
+  Milliseconds pingInterval = 0;
   Game game;
   Input input;
   TcpSocket socket;
   std::set<std::string> blackList;
   std::map<int, BoardPtr> newBoards;
+  std::map<int, SpectatorPtr> spectators;
+  std::map<int, unsigned> idleTimers;
+  TimerWheel timers;
+  Timer frameTimer;
+  EventTrace trace;
+  std::unique_ptr<Database> db;
 
 //-----------------------------------------------------------------------------
 public: // constructors
@@ -51,13 +92,21 @@ public: // destructor
 public: // static methods
   static Version getVersion();
 
+  /**
+   * @brief Ask a headless server to abort the current game and exit
+   * Safe to call from a signal handler.
+   */
+  static void requestShutdown() noexcept;
+  static bool isShutdownRequested() noexcept;
+
 //-----------------------------------------------------------------------------
 public: // methods
   void showHelp();
   bool init();
   bool run();
   bool isAutoStart() const { return autoStart; }
-  bool isRepeatOn() const { return repeat; }
+  bool isHeadless() const { return headless; }
+  bool isRepeatOn() const { return (repeat || headless); }
 
 //-----------------------------------------------------------------------------
 private: // methods
@@ -65,6 +114,10 @@ private: // methods
     sendToAll(p.toString());
   }
 
+  void sendToSpectators(const Printable& p) {
+    sendToSpectators(p.toString());
+  }
+
   bool send(Board& recipient, const Printable& p) {
     return send(recipient, p.toString());
   }
@@ -73,18 +126,24 @@ private: // methods
                      const std::string& question,
                      const char fieldDelimeter = 0);
 
+  std::string boardInfo(const Board&) const;
   Configuration newGameConfig();
+  std::vector<std::string> getJoinOptions() const;
 
   bool getGameTitle(std::string&);
+  bool confirmJoin(Board&, const std::vector<std::string>& options);
   bool handleUserInput(Coordinate);
   bool isServerHandle(const int) const;
+  bool isSpectatorHandle(const int) const;
   bool isUserHandle(const int) const;
   bool isValidPlayerName(const std::string&) const;
   bool quitGame(Coordinate);
+  bool runInteractive();
   bool sendBoard(Board& recipient, const Board&);
   bool sendGameInfo(Board&);
   bool sendYourBoard(Board&);
   bool waitForInput(const int timeout = -1);
+  int frameWait() const noexcept;
   bool send(Board& recipient, const std::string& msg,
             const bool removeOnFailure = true);
 
@@ -95,7 +154,10 @@ private: // methods
   void clearBlacklist(Coordinate);
   void clearScreen();
   void close();
+  void flushSpectators();
   void handlePlayerInput(const int handle);
+  void handleTimers();
+  void handleSpectatorInput(const int handle);
   void joinGame(BoardPtr&);
   void leaveGame(Board&);
   void nextTurn();
@@ -103,22 +165,29 @@ private: // methods
   void printGameInfo(Coordinate&);
   void printOptions(Coordinate&);
   void printPlayers(Coordinate&);
-  void rejoinGame(Board&);
+  void rejoinGame(Board&, const std::vector<std::string>& options);
   void removeNewBoard(const int);
   void removePlayer(Board&, const std::string& msg = "");
+  void removeSpectator(Spectator&, const std::string& msg = "");
   void saveResult();
   void sendBoardToAll(const Board&);
+  void sendBoardUpdate(Board&, const std::vector<unsigned>& squares);
   void sendGameResults();
+  void sendKeepAlive();
   void sendMessage(Board&);
   void sendMessage(Coordinate);
   void sendStart();
   void sendToAll(const std::string& msg);
+  void sendToSpectators(const std::string& msg);
   void setTaunt(Board&);
   void shoot(Board&);
   void skipBoard(Coordinate);
+  void skipPlayer(Board&, const std::string& reason);
   void skipTurn(Board&);
   void startGame(Coordinate);
   void startListening(const int backlog);
+  void startTurnTimer();
+  void watchGame(BoardPtr&);
 };
 
 } // namespace xbs
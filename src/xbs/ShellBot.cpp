@@ -8,14 +8,16 @@
 #include "Msg.h"
 #include "StringUtils.h"
 #include "Error.h"
+#include "Logger.h"
 
 namespace xbs
 {
 
 //-----------------------------------------------------------------------------
-ShellBot::ShellBot(const std::string& cmd)
+ShellBot::ShellBot(const std::string& cmd, const Milliseconds replyTimeout)
   : Bot("shellBot", Version("1.0")),
-    proc("ShellBot", cmd)
+    proc("ShellBot", cmd),
+    replyTimeout(replyTimeout)
 {
   proc.validate();
   proc.run();
@@ -23,7 +25,7 @@ ShellBot::ShellBot(const std::string& cmd)
     throw Error(Msg() << "Unabled to run bot command: " << cmd);
   }
 
-  std::string line = trimStr(proc.readln(1000));
+  std::string line = trimStr(proc.readln(INFO_TIMEOUT));
   if (line.empty()) {
     throw Error(Msg() << "No info message from bot command: " << cmd);
   }
@@ -45,9 +47,27 @@ ShellBot::ShellBot(const std::string& cmd)
       : info[3]);
 }
 
+//-----------------------------------------------------------------------------
+void ShellBot::flush() {
+  if (pending.size()) {
+    std::string data;
+    data.swap(pending);
+    proc.sendln(data);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void ShellBot::queue(const std::string& msg) {
+  pending += msg;
+  pending += '\n';
+  if (pending.size() >= MAX_PENDING_SIZE) {
+    flush();
+  }
+}
+
 //-----------------------------------------------------------------------------
 void ShellBot::yourBoard(const std::string& boardDescriptor) {
-  proc.sendln(Msg('Y') << boardDescriptor);
+  queue(Msg('Y') << boardDescriptor);
 }
 
 //-----------------------------------------------------------------------------
@@ -56,6 +76,8 @@ std::string ShellBot::newGame(const Configuration& config,
                               const unsigned playersJoined,
                               const bool gameStarted)
 {
+  shotRequests = 0; // requests left over from the last game are void
+
   CSVWriter msg = Msg('G')
       << serverVersion
       << config.getName()
@@ -72,9 +94,10 @@ std::string ShellBot::newGame(const Configuration& config,
     msg << ship.toString();
   }
 
-  proc.sendln(msg);
+  queue(msg);
+  flush();
 
-  std::string line = proc.readln(1000);
+  std::string line = proc.readln(INFO_TIMEOUT);
   if (line.empty()) {
     throw Error(Msg() << "No join message from bot: " << getBotName());
   }
@@ -99,15 +122,33 @@ std::string ShellBot::newGame(const Configuration& config) {
 
 //-----------------------------------------------------------------------------
 std::string ShellBot::getBestShot(Coordinate& bestShot) {
-  std::string line = trimStr(proc.readln(3000));
-  if (line.empty()) {
-    throw Error(Msg() << "No shot message from bot: " << getBotName());
+  if (!shotRequests) {
+    throw Error(Msg() << "No shot requested from bot: " << getBotName());
   }
 
-  std::vector<std::string> info = CSVReader(line, '|', true).readCells();
-  if (info.empty() || ((info[0] != "S") && (info[0] != "K"))) {
-    throw Error(Msg() << "Invalid shot message (" << line
-                << ") from bot: " << getBotName());
+  flush();
+
+  // one reply per shot request, only the reply to the newest one is used
+  const Timestamp deadline = (Timer::now() + replyTimeout);
+  std::string line;
+  std::vector<std::string> info;
+  while (shotRequests) {
+    const Milliseconds remain = (deadline - Timer::now());
+    line = (remain > 0) ? trimStr(proc.readln(remain)) : "";
+    if (line.empty()) {
+      throw Error(Msg() << "No shot message from bot: " << getBotName());
+    }
+
+    info = CSVReader(line, '|', true).readCells();
+    if (info.empty() || ((info[0] != "S") && (info[0] != "K"))) {
+      throw Error(Msg() << "Invalid shot message (" << line
+                  << ") from bot: " << getBotName());
+    }
+
+    if (--shotRequests) {
+      XBS_LOG_DEBUG() << "Ignoring stale shot message (" << line
+                      << ") from bot: " << getBotName();
+    }
   }
 
   if (info[0] == "K") {
@@ -130,7 +171,7 @@ std::string ShellBot::getBestShot(Coordinate& bestShot) {
 
 //-----------------------------------------------------------------------------
 void ShellBot::playerJoined(const std::string& player) {
-  proc.sendln(Msg('J') << player);
+  queue(Msg('J') << player);
 }
 
 //-----------------------------------------------------------------------------
@@ -139,7 +180,7 @@ void ShellBot::startGame(const std::vector<std::string>& playerOrder) {
   for (auto& player : playerOrder) {
     msg << player;
   }
-  proc.sendln(msg);
+  queue(msg);
 }
 
 //-----------------------------------------------------------------------------
@@ -147,7 +188,8 @@ void ShellBot::finishGame(const std::string& state,
                           const unsigned turnCount,
                           const unsigned playerCount)
 {
-  proc.sendln(Msg('F') << state << turnCount << playerCount);
+  queue(Msg('F') << state << turnCount << playerCount);
+  flush();
 }
 
 //-----------------------------------------------------------------------------
@@ -157,7 +199,8 @@ void ShellBot::playerResult(const std::string& player,
                             const unsigned turns,
                             const std::string& status)
 {
-  proc.sendln(Msg('R') << player << score << skips << turns << status);
+  queue(Msg('R') << player << score << skips << turns << status);
+  flush();
 }
 
 //-----------------------------------------------------------------------------
@@ -168,25 +211,29 @@ void ShellBot::updateBoard(const std::string& player,
                            const unsigned skips,
                            const unsigned turns)
 {
-  proc.sendln(Msg('B')
-              << player
-              << status
-              << boardDescriptor
-              << score
-              << skips
-              << ((turns == ~0U) ? 0 : turns));
+  queue(Msg('B')
+        << player
+        << status
+        << boardDescriptor
+        << score
+        << skips
+        << ((turns == ~0U) ? 0 : turns));
 }
 
 //-----------------------------------------------------------------------------
 void ShellBot::skipPlayerTurn(const std::string& player,
                               const std::string& reason)
 {
-  proc.sendln(Msg('K') << player << reason);
+  queue(Msg('K') << player << reason);
 }
 
 //-----------------------------------------------------------------------------
 void ShellBot::updatePlayerToMove(const std::string& player) {
-  proc.sendln(Msg('N') << player);
+  queue(Msg('N') << player);
+  if (player == getPlayerName()) {
+    shotRequests++;
+    flush();
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -194,7 +241,7 @@ void ShellBot::messageFrom(const std::string& from,
                            const std::string& message,
                            const std::string& group)
 {
-  proc.sendln(Msg('M') << from << message << group);
+  queue(Msg('M') << from << message << group);
 }
 
 //-----------------------------------------------------------------------------
@@ -202,7 +249,7 @@ void ShellBot::hitScored(const std::string& player,
                          const std::string& target,
                          const Coordinate& hitCoordinate)
 {
-  proc.sendln(Msg('H') << player << target << hitCoordinate);
+  queue(Msg('H') << player << target << hitCoordinate);
 }
 
 } // namespace xbs
@@ -8,20 +8,37 @@
 #include "Platform.h"
 #include "Bot.h"
 #include "ShellProcess.h"
+#include "Timer.h"
 #include "Version.h"
 
 namespace xbs
 {
 
+//-----------------------------------------------------------------------------
+// Messages that don't require a reply are buffered and written to the bot
+// process together with the next message that does require a reply (or when
+// the buffer fills up), so the bot gets several messages per pipe write.
 //-----------------------------------------------------------------------------
 class ShellBot : public Bot {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    DEFAULT_REPLY_TIMEOUT = 3000, // milliseconds
+    INFO_TIMEOUT = 1000, // milliseconds
+    MAX_PENDING_SIZE = 4096
+  };
+
 //-----------------------------------------------------------------------------
 private: // variables
   ShellProcess proc;
+  Milliseconds replyTimeout;
+  std::string pending;
+  unsigned shotRequests = 0;
 
 //-----------------------------------------------------------------------------
 public: // constructors
-  ShellBot(const std::string& shellCommand);
+  explicit ShellBot(const std::string& shellCommand,
+                    const Milliseconds replyTimeout = DEFAULT_REPLY_TIMEOUT);
   ShellBot() = delete;
   ShellBot(ShellBot&&) = delete;
   ShellBot(const ShellBot&) = delete;
@@ -60,11 +77,22 @@ public: // Bot implementation
 
 //-----------------------------------------------------------------------------
 public: // methods
+  Milliseconds getReplyTimeout() const noexcept { return replyTimeout; }
+  unsigned getOutstandingShots() const noexcept { return shotRequests; }
+  void setReplyTimeout(const Milliseconds timeout) noexcept {
+    replyTimeout = timeout;
+  }
+
+  void flush();
   void yourBoard(const std::string& boardDescriptor);
   std::string newGame(const Configuration& gameConfig,
                       const Version& serverVersion,
                       const unsigned playersJoined,
                       const bool gameStarted);
+
+//-----------------------------------------------------------------------------
+private: // methods
+  void queue(const std::string& msg);
 };
 
 } // namespace nlpcore
@@ -10,6 +10,7 @@
 #include "StringUtils.h"
 #include "Error.h"
 #include <csignal>
+#include <poll.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 
@@ -81,6 +82,8 @@ void ShellProcess::close() noexcept {
     if (!waitForExit(1000)) {
       if (::kill(childPid, SIGTERM) || !waitForExit(1000)) {
         ::kill(childPid, SIGKILL);
+        int status;
+        while ((::waitpid(childPid, &status, 0) < 0) && (errno == EINTR)) { }
         exitStatus = -2;
         childPid = -1;
       }
@@ -159,7 +162,7 @@ void ShellProcess::runChild() {
   assert(childPid == 0);
   const int pid = getpid();
   try {
-    Logger::debug() << "ShellProcess(" << alias << ").runChild(" << pid
+    XBS_LOG_DEBUG() << "ShellProcess(" << alias << ").runChild(" << pid
                     << ") started";
 
     // child only "writes" to parent err, so close "read" end of errPipe
@@ -200,7 +203,7 @@ void ShellProcess::runChild() {
     }
     argv.push_back(nullptr);
 
-    Logger::debug() << "ShellProcess(" << alias << ").runChild(" << pid
+    XBS_LOG_DEBUG() << "ShellProcess(" << alias << ").runChild(" << pid
                     << ") " << shellCommand;
 
     execvp(shellExecutable.c_str(), argv.data());
@@ -225,73 +228,124 @@ std::string ShellProcess::readln(const Milliseconds timeout) const {
   return readln(inPipe.getReadHandle(), timeout);
 }
 
+//-----------------------------------------------------------------------------
+bool ShellProcess::nextLine(std::string& line) const {
+  const size_t eol = readBuffer.find('\n', readPos);
+  if (eol == std::string::npos) {
+    return false;
+  }
+
+  line.assign(readBuffer, readPos, (eol - readPos));
+  readPos = static_cast<unsigned>(eol + 1);
+  if (readPos >= readBuffer.size()) {
+    readBuffer.clear();
+    readPos = 0;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+int ShellProcess::fillReadBuffer(const int fd) const {
+  if (readPos) {
+    readBuffer.erase(0, readPos);
+    readPos = 0;
+  }
+
+  char buf[4096];
+  int total = 0;
+  while (true) {
+    const ssize_t n = ::read(fd, buf, sizeof(buf));
+    if (n > 0) {
+      readBuffer.append(buf, n);
+      total += static_cast<int>(n);
+    } else if (n == 0) {
+      return total ? total : -1; // end of file
+    } else if (errno == EINTR) {
+      continue;
+    } else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+      return total;
+    } else {
+      throw Error(Msg() << "ShellProcess(" << alias << ").readln(" << fd
+                  << ") read failed: " << toError(errno));
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 std::string ShellProcess::readln(const int fd, const Milliseconds timeout)
 const {
-  timeval* tmout = nullptr;
-  timeval tv;
-  if (timeout) {
-    tv.tv_sec = (timeout / 1000);
-    tv.tv_usec = (10 * (timeout % 1000));
-    tmout = &tv;
-  }
+  const Timestamp deadline = (timeout ? (Timer::now() + timeout) : 0);
+  const int fd1 = Pipe::signalPipe().getReadHandle();
+
+  std::string line;
+  while (!nextLine(line)) {
+    int wait = -1;
+    if (timeout) {
+      const Milliseconds remaining = (deadline - Timer::now());
+      if (remaining <= 0) {
+        XBS_LOG_DEBUG() << "ShellProcess(" << alias << ").readln("
+                        << childPid << ") timeout";
+        return "";
+      }
+      wait = static_cast<int>(remaining);
+    }
 
-  const int fd1 = Pipe::SELF_PIPE.getReadHandle();
-  const int maxFd = std::max<int>(fd, fd1);
-  fd_set fds;
-  FD_ZERO(&fds);
-  FD_SET(fd1, &fds);
-  FD_SET(fd, &fds);
+    pollfd fds[2];
+    fds[0].fd = fd;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    fds[1].fd = fd1;
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
 
-  int ret;
-  while ((ret = ::select((maxFd + 1), &fds, nullptr, nullptr, tmout))) {
+    const int ret = ::poll(fds, ((fd1 < 0) ? 1 : 2), wait);
     if (ret < 0) {
       if (errno == EINTR) {
         continue;
-      } else {
-        throw Error(Msg() << "ShellProcess(" << alias << ").readln(" << fd
-                    << ") select failed: " << toError(errno));
       }
+      throw Error(Msg() << "ShellProcess(" << alias << ").readln(" << fd
+                  << ") poll failed: " << toError(errno));
+    } else if (ret == 0) {
+      continue; // check deadline
     }
 
-    if (FD_ISSET(fd1, &fds)) {
+    if (fds[1].revents & POLLIN) {
       char sbuf[4096];
       ssize_t n;
-      while ((n = ::read(fd, sbuf, sizeof(sbuf))) > 0) {
+      while ((n = ::read(fd1, sbuf, (sizeof(sbuf) - 1))) > 0) {
         sbuf[n] = 0;
-        Logger::debug() << "SelfPipe: " << trimStr(sbuf);
+        XBS_LOG_DEBUG() << "SelfPipe: " << trimStr(sbuf);
       }
     }
 
-    if (FD_ISSET(fd, &fds)) {
-      std::string line;
-      char ch = 0;
-      // TODO figure how to do non-blocking read
-      //      otherwise timeout only works until we start reading
-      while ((::read(fd, &ch, 1) == 1) && (ch != '\n')) {
-        line += ch;
-      }
-      Logger::debug() << "ShellProcess(" << alias << ").readln(" << childPid
-                      << ") received: '" << line << "'";
-      return line;
+    if ((fds[0].revents & (POLLIN | POLLHUP | POLLERR)) &&
+        (fillReadBuffer(fd) < 0))
+    {
+      // end of file, return whatever is left of the last line
+      line.assign(readBuffer, readPos, std::string::npos);
+      readBuffer.clear();
+      readPos = 0;
+      break;
     }
   }
 
-  Logger::debug() << "ShellProcess(" << alias
-                  << ").waitForExit(" << childPid
-                  << ") timeout";
-  return "";
+  XBS_LOG_DEBUG() << "ShellProcess(" << alias << ").readln(" << childPid
+                  << ") received: '" << line << "'";
+  return line;
 }
 
 //-----------------------------------------------------------------------------
 void ShellProcess::runParent() {
   ASSERT(childPid > 0);
 
-  Logger::debug() << "ShellProcess(" << alias << ").runParent(" << childPid
+  XBS_LOG_DEBUG() << "ShellProcess(" << alias << ").runParent(" << childPid
                   << ") started";
 
   // parent only "reads" from inPipe, so close the "write" end of the pipe
   inPipe.closeWrite();
+  inPipe.setNonBlockingRead();
+  readBuffer.clear();
+  readPos = 0;
 
   // parent only "writes" to outPipe, so close the "read" end of the pipe
   outPipe.closeRead();
@@ -331,7 +385,7 @@ void ShellProcess::sendln(const std::string& line) const {
     data += '\n';
   }
 
-  Logger::debug() << "ShellProcess(" << alias << ").sendln(" << childPid
+  XBS_LOG_DEBUG() << "ShellProcess(" << alias << ").sendln(" << childPid
                   << ") '" << line << "'";
 
   outPipe.writeln(data);
@@ -370,54 +424,74 @@ bool ShellProcess::waitForExit(const Milliseconds timeout) noexcept {
 
   exitStatus = -1;
 
-  timeval tv;
-  tv.tv_sec = (timeout / 1000);
-  tv.tv_usec = (10 * (timeout % 1000));
+  // readln() may already have consumed the SIGCHLD wakeup, so check first
+  int result = ::waitpid(childPid, &exitStatus, WNOHANG);
+  if ((result != childPid) && (timeout > 0)) {
+    timeval tv;
+    tv.tv_sec = (timeout / 1000);
+    tv.tv_usec = (1000 * (timeout % 1000));
 
-  const int fd = Pipe::SELF_PIPE.getReadHandle();
-  fd_set fds;
-  FD_ZERO(&fds);
-  FD_SET(fd, &fds);
+    int fd = -1;
+    try {
+      fd = Pipe::signalPipe().getReadHandle();
+    } catch (...) { }
 
-  int ret;
-  while ((ret = ::select((fd + 1), &fds, nullptr, nullptr, &tv))) {
-    if (ret < 0) {
-      try {
-        Logger::debug() << "ShellProcess(" << alias
-                        << ").waitForExit(" << childPid
-                        << ") select failed: " << toError(errno);
-      } catch (...) { }
-      if (errno == EINTR) {
-        continue;
-      } else {
-        return false;
+    if (fd < 0) {
+      // no signal pipe, wait out the timeout and check once
+      ::select(0, nullptr, nullptr, nullptr, &tv);
+    } else {
+      fd_set fds;
+      while (true) {
+        FD_ZERO(&fds);
+        FD_SET(fd, &fds);
+        const int ret = ::select((fd + 1), &fds, nullptr, nullptr, &tv);
+        if (ret == 0) {
+          break;
+        } else if (ret < 0) {
+          try {
+            XBS_LOG_DEBUG() << "ShellProcess(" << alias
+                            << ").waitForExit(" << childPid
+                            << ") select failed: " << toError(errno);
+          } catch (...) { }
+          if (errno == EINTR) {
+            continue;
+          }
+          break;
+        }
+
+        char sbuf[4096];
+        ssize_t n;
+        while ((n = ::read(fd, sbuf, (sizeof(sbuf) - 1))) > 0) {
+          try {
+            sbuf[n] = 0;
+            XBS_LOG_DEBUG() << "SelfPipe: " << trimStr(sbuf);
+          } catch (...) { }
+        }
+
+        // every thread is woken by every SIGCHLD, this one may be for
+        // another thread's child process
+        result = ::waitpid(childPid, &exitStatus, WNOHANG);
+        if (result == childPid) {
+          break;
+        } else if (result < 0) {
+          try {
+            Logger::error() << "ShellProcess(" << alias
+                            << ").waitForExit(" << childPid
+                            << ") waitpid = " << result << " "
+                            << toError(errno);
+          } catch (...) { }
+        }
       }
     }
 
-    char sbuf[4096];
-    ssize_t n;
-    while ((n = ::read(fd, sbuf, sizeof(sbuf))) > 0) {
-      try {
-        sbuf[n] = 0;
-        Logger::debug() << "SelfPipe: " << trimStr(sbuf);
-      } catch (...) { }
-    }
-
-    int result = ::waitpid(childPid, &exitStatus, 0);
-    if (result == childPid) {
-      break;
+    if (result != childPid) {
+      result = ::waitpid(childPid, &exitStatus, WNOHANG);
     }
-
-    try {
-      Logger::error() << "ShellProcess(" << alias
-                      << ").waitForExit(" << childPid
-                      << ") waitpid = " << result << " " << toError(errno);
-    } catch (...) { }
   }
 
-  if (ret == 0) {
+  if (result != childPid) {
     try {
-      Logger::debug() << "ShellProcess(" << alias
+      XBS_LOG_DEBUG() << "ShellProcess(" << alias
                       << ").waitForExit(" << childPid
                       << ") timeout";
     } catch (...) { }
@@ -425,7 +499,7 @@ bool ShellProcess::waitForExit(const Milliseconds timeout) noexcept {
   }
 
   try {
-    Logger::debug() << "ShellProcess(" << alias
+    XBS_LOG_DEBUG() << "ShellProcess(" << alias
                     << ").waitForExit(" << childPid
                     << ") child exit status = " << exitStatus;
   } catch (...) { }
@@ -34,6 +34,8 @@ private: // variables
   Pipe inPipe;
   Pipe outPipe;
   Pipe errPipe; // TODO add interface(s) to use errPipe
+  mutable std::string readBuffer;
+  mutable unsigned readPos = 0;
 
 //-----------------------------------------------------------------------------
 public: // constructors
@@ -97,6 +99,8 @@ public: // operator overloads
 
 //-----------------------------------------------------------------------------
 private: // methods
+  bool nextLine(std::string& line) const;
+  int fillReadBuffer(const int fd) const;
   std::string readln(const int fd, const Milliseconds timeout) const;
   void runChild();
   void runParent();
@@ -0,0 +1,104 @@
+//-----------------------------------------------------------------------------
+// Spectator.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "Spectator.h"
+#include "CSVWriter.h"
+#include "Logger.h"
+#include "StringUtils.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+std::string Spectator::toString() const {
+  CSVWriter params(',', true);
+  params << socket << ("queued=" + toStr(queue.size()));
+  if (dropped) {
+    params << ("dropped=" + toStr(dropped));
+  }
+  return ("Spectator(" + params.toString() + ')');
+}
+
+//-----------------------------------------------------------------------------
+bool Spectator::flush() {
+  while (queue.size()) {
+    const std::string& data = queue.front().data;
+    const int n = socket.trySend((data.c_str() + offset),
+                                 static_cast<unsigned>(data.size() - offset));
+    if (n < 0) {
+      return false;
+    }
+
+    offset += static_cast<unsigned>(n);
+    if (offset < data.size()) {
+      break; // socket buffer is full, try again later
+    }
+
+    queueSize -= static_cast<unsigned>(data.size());
+    queue.pop_front();
+    offset = 0;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Spectator::send(const std::string& msg) {
+  return enqueue("", msg);
+}
+
+//-----------------------------------------------------------------------------
+bool Spectator::sendBoard(const std::string& player, const std::string& msg) {
+  return enqueue(player, msg);
+}
+
+//-----------------------------------------------------------------------------
+bool Spectator::enqueue(const std::string& player, const std::string& msg) {
+  Entry entry { player, "" };
+  if (!socket.isOpen() || !socket.encode(msg, entry.data)) {
+    return false;
+  }
+
+  // replace older board message for the same player, unless partially sent
+  if (player.size()) {
+    for (auto it = queue.begin(); it != queue.end(); ++it) {
+      if ((it->player == player) && (!offset || (it != queue.begin()))) {
+        queueSize -= static_cast<unsigned>(it->data.size());
+        queue.erase(it);
+        break;
+      }
+    }
+  }
+
+  queueSize += static_cast<unsigned>(entry.data.size());
+  queue.push_back(std::move(entry));
+
+  if (queueSize > MAX_QUEUE_SIZE) {
+    trimQueue();
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void Spectator::trimQueue() {
+  auto it = queue.begin();
+  if (offset && (it != queue.end())) {
+    ++it; // don't drop partially sent message
+  }
+
+  const unsigned count = dropped;
+  while ((queueSize > MAX_QUEUE_SIZE) && (it != queue.end())) {
+    if (it->player.empty()) {
+      queueSize -= static_cast<unsigned>(it->data.size());
+      it = queue.erase(it);
+      dropped++;
+    } else {
+      ++it;
+    }
+  }
+
+  XBS_LOG_DEBUG() << (*this) << " dropped " << (dropped - count)
+                  << " queued messages";
+}
+
+} // namespace xbs
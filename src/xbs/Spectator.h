@@ -0,0 +1,94 @@
+//-----------------------------------------------------------------------------
+// Spectator.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_SPECTATOR_H
+#define XBS_SPECTATOR_H
+
+#include "Platform.h"
+#include "Printable.h"
+#include "TcpSocket.h"
+#include <deque>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// The Spectator class is a read-only connection to a game in progress.
+// Messages sent to a spectator are queued and written without blocking
+// whenever the server calls flush().  If a spectator can't keep up its
+// queue is kept small by replacing queued board messages with the newest
+// board message for the same player, and by dropping the oldest of the
+// other queued messages.
+//-----------------------------------------------------------------------------
+class Spectator : public Printable {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    MAX_QUEUE_SIZE = (64 * 1024)
+  };
+
+//-----------------------------------------------------------------------------
+private: // structs
+  struct Entry {
+    std::string player; // set for board messages, empty for all others
+    std::string data;   // encoded message
+  };
+
+//-----------------------------------------------------------------------------
+private: // variables
+  TcpSocket socket;
+  std::deque<Entry> queue;
+  unsigned queueSize = 0;
+  unsigned offset = 0;
+  unsigned dropped = 0;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  Spectator() = delete;
+  Spectator(Spectator&&) = delete;
+  Spectator(const Spectator&) = delete;
+  Spectator& operator=(Spectator&&) = delete;
+  Spectator& operator=(const Spectator&) = delete;
+
+  explicit Spectator(const std::string& name, TcpSocket&& tmpSocket)
+    : socket(std::move(tmpSocket))
+  {
+    socket.setLabel(name);
+  }
+
+//-----------------------------------------------------------------------------
+public: // Printable implementation
+  std::string toString() const override;
+
+//-----------------------------------------------------------------------------
+public: // methods
+  std::string getAddress() const { return socket.getAddress(); }
+  std::string getName() const { return socket.getLabel(); }
+  bool hasQueuedMessages() const noexcept { return !queue.empty(); }
+  bool isConnected() const noexcept { return socket.isOpen(); }
+  int handle() const noexcept { return socket.getHandle(); }
+  unsigned getDropCount() const noexcept { return dropped; }
+  void disconnect() noexcept { socket.close(); }
+  void setBinary(const bool flag) noexcept { socket.setBinary(flag); }
+
+  bool flush();
+  bool send(const std::string& msg);
+  bool sendBoard(const std::string& player, const std::string& msg);
+
+  bool send(const Printable& p) {
+    return send(p.toString());
+  }
+
+//-----------------------------------------------------------------------------
+private: // methods
+  bool enqueue(const std::string& player, const std::string& msg);
+  void trimQueue();
+};
+
+//-----------------------------------------------------------------------------
+typedef std::shared_ptr<Spectator> SpectatorPtr;
+
+} // namespace xbs
+
+#endif // XBS_SPECTATOR_H
@@ -3,6 +3,7 @@
 // Copyright (c) 2017 Shawn Chidester, All Rights Reserved.
 //-----------------------------------------------------------------------------
 #include "StringUtils.h"
+#include <cstdio>
 #include <cstring>
 
 namespace xbs
@@ -520,6 +521,54 @@ std::string toLower(std::string str) {
   return str;
 }
 
+//-----------------------------------------------------------------------------
+unsigned formatNumber(char* buf, u_int64_t x) noexcept {
+  char tmp[NUMBER_BUFFER_SIZE];
+  char* const end = (tmp + sizeof(tmp));
+  char* p = end;
+  do {
+    *--p = static_cast<char>('0' + (x % 10));
+    x /= 10;
+  } while (x);
+  const unsigned len = static_cast<unsigned>(end - p);
+  memcpy(buf, p, len);
+  return len;
+}
+
+//-----------------------------------------------------------------------------
+unsigned formatNumber(char* buf, const int64_t x) noexcept {
+  if (x < 0) {
+    buf[0] = '-';
+    return (1 + formatNumber((buf + 1), (0 - static_cast<u_int64_t>(x))));
+  }
+  return formatNumber(buf, static_cast<u_int64_t>(x));
+}
+
+//-----------------------------------------------------------------------------
+static int formatDouble(char* buf, const size_t size, const double x,
+                        const int precision) noexcept
+{
+  return (precision < 0) ? snprintf(buf, size, "%g", x)
+                         : snprintf(buf, size, "%.*f", precision, x);
+}
+
+//-----------------------------------------------------------------------------
+void appendNumber(std::string& dest, const double x, const int precision) {
+  char buf[NUMBER_BUFFER_SIZE];
+  const int len = formatDouble(buf, sizeof(buf), x, precision);
+  if (len < 0) {
+    return;
+  } else if (static_cast<size_t>(len) < sizeof(buf)) {
+    dest.append(buf, static_cast<size_t>(len));
+  } else {
+    // fixed notation of a very large value, format in place
+    const size_t pos = dest.size();
+    dest.resize(pos + len + 1);
+    formatDouble(&dest[pos], (len + 1), x, precision);
+    dest.resize(pos + len);
+  }
+}
+
 //-----------------------------------------------------------------------------
 std::string toError(const int errorNumber) {
   return strerror(errorNumber);
@@ -6,8 +6,10 @@
 #define XBS_STRING_UTILS_H
 
 #include "Platform.h"
+#include "Printable.h"
 #include <iomanip>
 #include <sstream>
+#include <type_traits>
 
 namespace xbs
 {
@@ -169,6 +171,31 @@ extern std::string replace(const std::string& str,
                            const std::string& substr,
                            const std::string& replacement);
 
+//-----------------------------------------------------------------------------
+// Stack buffer number formatting.  formatNumber() writes the digits of x to
+// buf, which must hold at least NUMBER_BUFFER_SIZE chars, and returns the
+// number of chars written.  No nul terminator is added.
+//-----------------------------------------------------------------------------
+enum {
+  NUMBER_BUFFER_SIZE = 32
+};
+
+//-----------------------------------------------------------------------------
+extern unsigned formatNumber(char* buf,
+                             u_int64_t x) noexcept;
+
+//-----------------------------------------------------------------------------
+extern unsigned formatNumber(char* buf,
+                             const int64_t x) noexcept;
+
+//-----------------------------------------------------------------------------
+// Append x to dest in std::ostream default notation, or in fixed notation
+// with the given number of decimal places when precision >= 0
+//-----------------------------------------------------------------------------
+extern void appendNumber(std::string& dest,
+                         const double x,
+                         const int precision = -1);
+
 //-----------------------------------------------------------------------------
 inline std::string toStr(const char x) {
   if ((x >= ' ') & (x <= '~')) {
@@ -201,12 +228,76 @@ inline std::string toStr(const bool x) {
   return x ? "true" : "false";
 }
 
+//-----------------------------------------------------------------------------
+// appendStr() appends the same text toStr() returns, without building a
+// temporary stringstream for numbers, strings or Printable objects
+//-----------------------------------------------------------------------------
+inline void appendStr(std::string& dest, const char x) {
+  dest += toStr(x);
+}
+
+//-----------------------------------------------------------------------------
+inline void appendStr(std::string& dest, const char* x) {
+  if (x) {
+    dest += x;
+  }
+}
+
+//-----------------------------------------------------------------------------
+inline void appendStr(std::string& dest, const std::string& x) {
+  dest += x;
+}
+
+//-----------------------------------------------------------------------------
+inline void appendStr(std::string& dest, const bool x) {
+  dest += (x ? "true" : "false");
+}
+
 //-----------------------------------------------------------------------------
 template<typename T>
-inline std::string toStr(const T& x) {
+inline typename std::enable_if<(std::is_integral<T>::value &&
+                                (sizeof(T) > sizeof(char)))>::type
+appendStr(std::string& dest, const T x) {
+  char buf[NUMBER_BUFFER_SIZE];
+  const unsigned len = std::is_signed<T>::value
+      ? formatNumber(buf, static_cast<int64_t>(x))
+      : formatNumber(buf, static_cast<u_int64_t>(x));
+  dest.append(buf, len);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+inline typename std::enable_if<(std::is_floating_point<T>::value &&
+                                (sizeof(T) <= sizeof(double)))>::type
+appendStr(std::string& dest, const T x) {
+  appendNumber(dest, x);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+inline typename std::enable_if<std::is_base_of<Printable, T>::value>::type
+appendStr(std::string& dest, const T& x) {
+  dest += x.toString();
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+inline typename std::enable_if<!(std::is_arithmetic<T>::value &&
+                                 (sizeof(T) > sizeof(char)) &&
+                                 (sizeof(T) <= sizeof(u_int64_t))) &&
+                               !std::is_base_of<Printable, T>::value>::type
+appendStr(std::string& dest, const T& x) {
   std::stringstream ss;
   ss << x;
-  return ss.str();
+  dest += ss.str();
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+inline std::string toStr(const T& x) {
+  std::string str;
+  appendStr(str, x);
+  return str;
 }
 
 //-----------------------------------------------------------------------------
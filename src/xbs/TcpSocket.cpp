@@ -4,6 +4,7 @@
 //-----------------------------------------------------------------------------
 #include "TcpSocket.h"
 #include "CSVWriter.h"
+#include "FrameCodec.h"
 #include "Input.h"
 #include "Logger.h"
 #include "Msg.h"
@@ -44,6 +45,9 @@ std::string TcpSocket::toString() const {
   if (handle >= 0) {
     params << ("handle=" + toStr(handle));
   }
+  if (binary) {
+    params << "binary";
+  }
   return ("TcpSocket(" + params.toString() + ')');
 }
 
@@ -53,10 +57,12 @@ TcpSocket::TcpSocket(TcpSocket&& other) noexcept
     address(std::move(other.address)),
     port(other.port),
     handle(other.handle),
+    binary(other.binary),
     mode(other.mode)
 {
   other.port   = -1;
   other.handle = -1;
+  other.binary = false;
   other.mode   = Unknown;
 }
 
@@ -68,21 +74,19 @@ TcpSocket& TcpSocket::operator=(TcpSocket&& other) noexcept {
     address      = std::move(other.address);
     port         = other.port;
     handle       = other.handle;
+    binary       = other.binary;
     mode         = other.mode;
     other.port   = -1;
     other.handle = -1;
+    other.binary = false;
     other.mode   = Unknown;
   }
   return (*this);
 }
 
 //-----------------------------------------------------------------------------
-bool TcpSocket::send(const std::string& msg) const {
-  if ((handle < 0) || (mode == Server)) {
-    Logger::error() << "send(" << msg.size() << ',' << msg << ") called on "
-                    << (*this);
-    return false;
-  } else if (isEmpty(msg)) {
+bool TcpSocket::encode(const std::string& msg, std::string& data) const {
+  if (isEmpty(msg)) {
     Logger::error() << (*this) << ".send() empty message";
     return false;
   } else if (msg.size() >= Input::BUFFER_SIZE) {
@@ -96,10 +100,31 @@ bool TcpSocket::send(const std::string& msg) const {
     return false;
   }
 
-  std::string tmp(msg);
-  tmp += '\n';
+  if (binary) {
+    FrameCodec::encode(msg, data);
+  } else {
+    data.clear();
+    data.reserve(msg.size() + 1);
+    data += msg;
+    data += '\n';
+  }
+  return true;
+}
 
-  Logger::debug() << (*this) << ".send(" << tmp.size() << "," << msg << ')';
+//-----------------------------------------------------------------------------
+bool TcpSocket::send(const std::string& msg) const {
+  if ((handle < 0) || (mode == Server)) {
+    Logger::error() << "send(" << msg.size() << ',' << msg << ") called on "
+                    << (*this);
+    return false;
+  }
+
+  std::string tmp;
+  if (!encode(msg, tmp)) {
+    return false;
+  }
+
+  XBS_LOG_DEBUG() << (*this) << ".send(" << tmp.size() << "," << msg << ')';
 
   size_t n = ::send(handle, tmp.c_str(), tmp.size(), MSG_NOSIGNAL);
   if (n != tmp.size()) {
@@ -110,6 +135,27 @@ bool TcpSocket::send(const std::string& msg) const {
   return true;
 }
 
+//-----------------------------------------------------------------------------
+int TcpSocket::trySend(const char* data, const unsigned size) const {
+  if ((handle < 0) || (mode == Server)) {
+    Logger::error() << "trySend(" << size << ") called on " << (*this);
+    return -1;
+  }
+
+  const ssize_t n = ::send(handle, data, size, (MSG_NOSIGNAL | MSG_DONTWAIT));
+  if (n < 0) {
+    if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) {
+      return 0;
+    }
+    Logger::error() << (*this) << ".trySend(" << size << ") failed: "
+                    << toError(errno);
+    return -1;
+  }
+
+  XBS_LOG_DEBUG() << (*this) << ".trySend(" << size << ") sent " << n;
+  return static_cast<int>(n);
+}
+
 //-----------------------------------------------------------------------------
 void TcpSocket::close() noexcept {
   if (handle >= 0) {
@@ -128,6 +174,7 @@ void TcpSocket::close() noexcept {
       }
     }
     handle = -1;
+    binary = false;
   }
 }
 
@@ -145,7 +192,7 @@ TcpSocket TcpSocket::accept() const {
     const int newHandle = ::accept(handle, (sockaddr*)&addr, &len);
     if (newHandle < 0) {
       if (errno == EINTR) {
-        Logger::debug() << (*this) << ".accept() interrupted, trying again";
+        XBS_LOG_DEBUG() << (*this) << ".accept() interrupted, trying again";
         continue;
       } else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
         return TcpSocket();
@@ -159,7 +206,7 @@ TcpSocket TcpSocket::accept() const {
     }
 
     TcpSocket sock(inet_ntoa(addr.sin_addr), port, newHandle);
-    Logger::debug() << (*this) << ".accept() " << sock;
+    XBS_LOG_DEBUG() << (*this) << ".accept() " << sock;
     return std::move(sock);
   }
 }
@@ -19,6 +19,7 @@ private: // variables
   std::string address;
   int port = -1;
   int handle = -1;
+  bool binary = false;
   enum Mode { Unknown, Client, Server, Remote } mode = Unknown;
 
 //-----------------------------------------------------------------------------
@@ -56,6 +57,7 @@ public: // Printable implementation
 
 //-----------------------------------------------------------------------------
 public: // methods
+  bool isBinary() const noexcept { return binary; }
   bool isOpen() const noexcept { return (handle >= 0); }
   bool send(const Printable& p) const { return send(p.toString()); }
   int getHandle() const noexcept { return handle; }
@@ -63,9 +65,12 @@ public: // methods
   Mode getMode() const noexcept { return mode; }
   std::string getAddress() const { return address; }
   std::string getLabel() const { return label; }
+  void setBinary(const bool value) noexcept { binary = value; }
   void setLabel(const std::string& value) { label = value; }
 
+  bool encode(const std::string& msg, std::string& data) const;
   bool send(const std::string&) const;
+  int trySend(const char* data, const unsigned size) const;
   void close() noexcept;
   TcpSocket accept() const;
   TcpSocket& connect(const std::string& hostAddress, const int port);
@@ -5,8 +5,8 @@
 #include "Timer.h"
 #include <thread>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <cinttypes>
+#include <cstdio>
 #include <sys/time.h>
 
 namespace xbs
@@ -25,12 +25,10 @@ Timer::toString(const Milliseconds ms) {
   const Milliseconds m = ((ms % ONE_HOUR) / ONE_MINUTE);
   const Milliseconds s = ((ms % ONE_MINUTE) / ONE_SECOND);
   const Milliseconds p = (ms % ONE_SECOND);
-  std::stringstream ss;
-  ss << std::setfill('0') << h << ':'
-     << std::setw(2) << m << std::setw(0) << ':'
-     << std::setw(2) << s << std::setw(0) << '.'
-     << std::setw(3) << p;
-  return ss.str();
+  char buf[64];
+  snprintf(buf, sizeof(buf),
+           "%" PRId64 ":%02" PRId64 ":%02" PRId64 ".%03" PRId64, h, m, s, p);
+  return buf;
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,113 @@
+//-----------------------------------------------------------------------------
+// TimerWheel.cpp
+// Copyright (c) 2017 Shawn Chidester, All Rights Reserved.
+//-----------------------------------------------------------------------------
+#include "TimerWheel.h"
+#include "Error.h"
+#include "Msg.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+TimerWheel::TimerWheel(const Milliseconds resolution, const unsigned slotCount)
+  : resolution(resolution)
+{
+  if ((resolution < 1) || (slotCount < 1)) {
+    throw Error(Msg() << "Invalid timer wheel resolution (" << resolution
+                << ") or slot count (" << slotCount << ')');
+  }
+  slots.resize(slotCount);
+  currentTick = (Timer::now() / resolution);
+}
+
+//-----------------------------------------------------------------------------
+unsigned TimerWheel::schedule(const Milliseconds delay, const int type,
+                              const int value)
+{
+  if (!++lastID) {
+    ++lastID; // 0 is never a valid timer ID
+  }
+
+  // round up so timers never expire early
+  const Timestamp deadline = (Timer::now() + std::max<Milliseconds>(0, delay));
+  const int64_t tick = std::max<int64_t>((currentTick + 1),
+      ((deadline + resolution - 1) / resolution));
+
+  Entry entry;
+  entry.tick = tick;
+  entry.event.id = lastID;
+  entry.event.type = type;
+  entry.event.value = value;
+
+  slots[tick % slots.size()].push_back(entry);
+  pending.insert(lastID);
+  return lastID;
+}
+
+//-----------------------------------------------------------------------------
+bool TimerWheel::cancel(const unsigned id) {
+  // entry is removed from its slot when the wheel reaches it
+  return (pending.erase(id) > 0);
+}
+
+//-----------------------------------------------------------------------------
+int TimerWheel::timeout() const {
+  if (pending.empty()) {
+    return -1;
+  }
+
+  const int64_t count = static_cast<int64_t>(slots.size());
+  int64_t tick = (currentTick + 1);
+  for (; tick <= (currentTick + count); ++tick) {
+    for (const Entry& entry : slots[tick % count]) {
+      if ((entry.tick <= tick) && pending.count(entry.event.id)) {
+        return static_cast<int>(
+            std::max<Milliseconds>(0, ((tick * resolution) - Timer::now())));
+      }
+    }
+  }
+
+  // nothing due this revolution, wake up when it's done
+  return static_cast<int>(
+      std::max<Milliseconds>(0, ((tick * resolution) - Timer::now())));
+}
+
+//-----------------------------------------------------------------------------
+unsigned TimerWheel::advance(std::vector<Event>& expired) {
+  expired.clear();
+
+  const int64_t nowTick = (Timer::now() / resolution);
+  const int64_t count = static_cast<int64_t>(slots.size());
+  const int64_t steps = std::min<int64_t>((nowTick - currentTick), count);
+
+  for (int64_t i = 1; i <= steps; ++i) {
+    std::vector<Entry>& slot = slots[(currentTick + i) % count];
+    unsigned keep = 0;
+    for (unsigned n = 0; n < slot.size(); ++n) {
+      const Entry& entry = slot[n];
+      if (!pending.count(entry.event.id)) {
+        continue; // cancelled
+      } else if (entry.tick <= nowTick) {
+        pending.erase(entry.event.id);
+        expired.push_back(entry.event);
+      } else {
+        slot[keep++] = entry; // expires in a later revolution
+      }
+    }
+    slot.resize(keep);
+  }
+
+  currentTick = std::max(currentTick, nowTick);
+  return static_cast<unsigned>(expired.size());
+}
+
+//-----------------------------------------------------------------------------
+void TimerWheel::clear() {
+  pending.clear();
+  for (auto& slot : slots) {
+    slot.clear();
+  }
+}
+
+} // namespace xbs
@@ -0,0 +1,102 @@
+//-----------------------------------------------------------------------------
+// TimerWheel.h
+// Copyright (c) 2017 Shawn Chidester, All Rights Reserved.
+//-----------------------------------------------------------------------------
+#ifndef XBS_TIMER_WHEEL_H
+#define XBS_TIMER_WHEEL_H
+
+#include "Platform.h"
+#include "Timer.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// The TimerWheel class is a hashed timing wheel for scheduling many
+// one-shot timers from a single-threaded event loop.  Time is divided into
+// ticks of a fixed resolution and each timer is placed in the slot for the
+// tick it expires on.  Call timeout() to get the select() timeout and
+// advance() when the wait is over to collect expired timers.
+//-----------------------------------------------------------------------------
+class TimerWheel {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    DEFAULT_RESOLUTION = 100, // milliseconds
+    DEFAULT_SLOT_COUNT = 256
+  };
+
+//-----------------------------------------------------------------------------
+public: // structs
+  struct Event {
+    unsigned id;
+    int type;
+    int value;
+  };
+
+//-----------------------------------------------------------------------------
+private: // structs
+  struct Entry {
+    int64_t tick;
+    Event event;
+  };
+
+//-----------------------------------------------------------------------------
+private: // variables
+  Milliseconds resolution;
+  int64_t currentTick;
+  unsigned lastID = 0;
+  std::set<unsigned> pending;
+  std::vector<std::vector<Entry>> slots;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  TimerWheel(TimerWheel&&) = delete;
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(TimerWheel&&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  explicit TimerWheel(const Milliseconds resolution = DEFAULT_RESOLUTION,
+                      const unsigned slotCount = DEFAULT_SLOT_COUNT);
+
+//-----------------------------------------------------------------------------
+public: // methods
+  bool empty() const noexcept { return pending.empty(); }
+  unsigned size() const noexcept { return pending.size(); }
+
+  /**
+   * @brief Schedule a one-shot timer
+   * @param delay Milliseconds from now until the timer expires
+   * @param type Caller defined timer type, returned with the expired event
+   * @param value Caller defined timer value, returned with the expired event
+   * @return the timer ID, never 0
+   */
+  unsigned schedule(const Milliseconds delay, const int type,
+                    const int value = -1);
+
+  /**
+   * @brief Cancel a pending timer
+   * @param id The timer ID returned by schedule()
+   * @return true if the timer was pending
+   */
+  bool cancel(const unsigned id);
+
+  /**
+   * @return milliseconds until the next pending timer is due,
+   *         -1 if there are no pending timers
+   */
+  int timeout() const;
+
+  /**
+   * @brief Move the wheel to the current time
+   * @param[out] expired Populated with the events of all expired timers
+   * @return number of timers expired
+   */
+  unsigned advance(std::vector<Event>& expired);
+
+  void clear();
+};
+
+} // namespace xbs
+
+#endif // XBS_TIMER_WHEEL_H
@@ -0,0 +1,415 @@
+//-----------------------------------------------------------------------------
+// Tournament.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "Tournament.h"
+#include "CommandArgs.h"
+#include "Error.h"
+#include "Logger.h"
+#include "Msg.h"
+#include "PluginBot.h"
+#include "db/FileSysDatabase.h"
+#include "db/LogDatabase.h"
+#include "StringUtils.h"
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+void Tournament::showHelp() {
+  const std::string progname = CommandArgs::getInstance().getProgramName();
+  std::cout
+      << std::endl
+      << "usage: " << progname << " [OPTIONS] --plugin <lib> --plugin <lib> ..."
+      << std::endl << std::endl
+      << "GENERAL OPTIONS:" << std::endl
+      << "  --help                    Show help and exit" << std::endl
+      << "  -l, --log-level <level>   Set log level: DEBUG, INFO, WARN, ERROR "
+      << std::endl
+      << "  -f, --log-file <file>     Write log messages to given file"
+      << std::endl << std::endl
+      << "TOURNAMENT OPTIONS:" << std::endl
+      << "  --plugin <lib> [args]     Add bot from given shared library"
+      << std::endl
+      << "  -t, --title <title>       Set game title, default: tournament"
+      << std::endl
+      << "  -g, --games <count>       Set number of games, default: "
+      << DEFAULT_GAME_COUNT << std::endl
+      << "  -j, --workers <count>     Play games in parallel, default: "
+      << "number of cores" << std::endl
+      << "  -x, --width <value>       Set board width" << std::endl
+      << "  -y, --height <value>      Set board height" << std::endl
+      << "  -d, --db-dir <dir>        Save game stats to given directory"
+      << std::endl
+      << "  --db-log <file>           Save game stats to given log database"
+      << std::endl << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+bool Tournament::init() {
+  const CommandArgs& args = CommandArgs::getInstance();
+  if (args.has("--help")) {
+    showHelp();
+    return false;
+  }
+
+  plugins.clear();
+  int idx = -1;
+  while (true) {
+    const std::string plugin = args.getStrAfter("--plugin", "", idx, &idx);
+    if (idx < 0) {
+      break;
+    } else if (plugin.empty()) {
+      Logger::printError() << "--plugin option requires a library path";
+      return false;
+    }
+    plugins.push_back(plugin);
+  }
+
+  if (plugins.size() < 2) {
+    showHelp();
+    Logger::printError() << "At least 2 --plugin options are required";
+    return false;
+  }
+
+  const unsigned cores = std::max<unsigned>(
+      1, std::thread::hardware_concurrency());
+  const unsigned width = args.getUIntAfter({"-x", "--width"});
+  const unsigned height = args.getUIntAfter({"-y", "--height"});
+  gameCount = args.getUIntAfter({"-g", "--games"}, DEFAULT_GAME_COUNT);
+  workerCount = std::max<unsigned>(
+      1, args.getUIntAfter({"-j", "--workers"}, cores));
+  dbDir = args.getStrAfter({"-d", "--db-dir"});
+  dbLog = args.getStrAfter("--db-log");
+
+  config = Configuration::getDefaultConfiguration();
+  config.setName(args.getStrAfter({"-t", "--title"}, "tournament"))
+      .setMinPlayers(plugins.size())
+      .setMaxPlayers(plugins.size());
+  if (width || height) {
+    config.setBoardSize((width ? width : config.getBoardWidth()),
+                        (height ? height : config.getBoardHeight()));
+  }
+
+  if (!config) {
+    Logger::printError() << "Invalid tournament configuration";
+    return false;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void Tournament::run() {
+  // load all bots before any worker threads are started
+  std::vector<std::unique_ptr<Bot>> instances;
+  std::vector<std::vector<Bot*>> workers(workerCount);
+  for (auto& bots : workers) {
+    std::set<std::string> names;
+    for (const std::string& plugin : plugins) {
+      instances.push_back(std::unique_ptr<Bot>(new PluginBot(plugin)));
+      Bot& bot = (*instances.back());
+
+      // player names must be unique within a game
+      const std::string name = bot.getPlayerName();
+      for (unsigned n = 2; names.count(bot.getPlayerName()); ++n) {
+        bot.setPlayerName(name + '-' + toStr(n));
+      }
+      names.insert(bot.getPlayerName());
+      bots.push_back(&bot);
+    }
+  }
+
+  run(workers);
+}
+
+//-----------------------------------------------------------------------------
+void Tournament::run(const std::vector<std::vector<Bot*>>& workers) {
+  if (workers.empty()) {
+    throw Error("No tournament workers");
+  }
+
+  // game stats are only saved when a database is given
+  db.reset();
+  if (dbLog.size()) {
+    std::unique_ptr<LogDatabase> logDB(new LogDatabase());
+    logDB->open(dbLog);
+    db = std::move(logDB);
+  } else if (dbDir.size()) {
+    std::unique_ptr<FileSysDatabase> fileDB(new FileSysDatabase());
+    fileDB->open(dbDir);
+    db = std::move(fileDB);
+  }
+
+  assigned = 0;
+  played = 0;
+  aborted = 0;
+  stopped = false;
+  standings.clear();
+
+  std::cout << "Playing " << gameCount << " games of '" << config.getName()
+            << "' with " << workers.size() << " worker(s)" << std::endl;
+
+  std::vector<std::exception_ptr> errors(workers.size());
+  std::vector<std::thread> threads;
+  unsigned running = workers.size();
+  timer.start();
+
+  for (unsigned i = 0; i < workers.size(); ++i) {
+    threads.push_back(std::thread([this, &workers, &errors, &running, i]() {
+      try {
+        runWorker(workers[i]);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      if (errors[i]) {
+        stopped = true; // tell other workers to stop
+      }
+      running--;
+      gameDone.notify_all();
+    }));
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+      gameDone.wait_for(lock, std::chrono::milliseconds(PROGRESS_INTERVAL));
+      if (running && (timer.tock() >= PROGRESS_INTERVAL)) {
+        printProgress();
+      }
+    }
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (db) {
+    db->sync();
+  }
+
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  printStandings();
+}
+
+//-----------------------------------------------------------------------------
+bool Tournament::nextGame() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (stopped || (assigned >= gameCount)) {
+    return false;
+  }
+  assigned++;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void Tournament::runWorker(const std::vector<Bot*>& bots) {
+  while (nextGame()) {
+    playGame(bots);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Tournament::playGame(const std::vector<Bot*>& bots) {
+  Game game(config);
+  std::map<std::string, Bot*> players;
+  for (Bot* bot : bots) {
+    const std::string desc = bot->newGame(config);
+    BoardPtr board = std::make_shared<Board>(bot->getPlayerName(), config);
+    board->setLocal(true);
+    if (!board->updateDescriptor(desc) || !board->matchesConfig(config)) {
+      throw Error(Msg() << "Invalid board descriptor from "
+                  << bot->getPlayerName() << ": '" << desc << "'");
+    }
+    game.addBoard(board);
+    players[bot->getPlayerName()] = bot;
+  }
+
+  for (Bot* bot : bots) {
+    for (auto& board : game.getBoards()) {
+      bot->playerJoined(board->getName());
+    }
+  }
+
+  if (!game.start(true)) {
+    throw Error("Failed to start tournament game");
+  }
+
+  const std::vector<BoardPtr> boards = game.getBoards();
+  std::vector<std::string> order;
+  for (auto& board : boards) {
+    order.push_back(board->getName());
+  }
+
+  for (Bot* bot : bots) {
+    bot->startGame(order);
+    for (auto& board : boards) {
+      bot->updateBoard(board->getName(), board->getStatus(),
+                       board->maskedDescriptor(), board->getScore(),
+                       board->getSkips());
+    }
+  }
+
+  // every player can shoot every square of every opponent at most once
+  const unsigned maxRounds =
+      (config.getShipArea().getSize() * (boards.size() - 1));
+
+  while (true) {
+    BoardPtr shooter = game.boardToMove();
+    if (!shooter) {
+      throw Error("Board to move unknown!");
+    }
+
+    for (Bot* bot : bots) {
+      bot->updatePlayerToMove(shooter->getName());
+    }
+
+    Coordinate coord;
+    const std::string target = players[shooter->getName()]->getBestShot(coord);
+    BoardPtr targetBoard = target.size()
+        ? game.boardForPlayer(target, true)
+        : nullptr;
+
+    char id = 0;
+    if (targetBoard && (targetBoard != shooter)) {
+      id = game.shoot((*shooter), (*targetBoard), coord);
+    }
+
+    if (!id || Ship::isHit(id) || Ship::isMiss(id)) {
+      // a server would ask for another shot, here it costs the turn
+      game.skipTurn(*shooter);
+      if (target.size()) {
+        for (Bot* bot : bots) {
+          bot->skipPlayerTurn(shooter->getName(), "illegal shot");
+        }
+      }
+    } else {
+      const unsigned idx = targetBoard->getShipIndex(coord);
+      const SquareUpdates squares {
+        std::make_pair(idx, Ship::mask(targetBoard->getSquare(idx)))
+      };
+      for (Bot* bot : bots) {
+        if (Ship::isValidID(id)) {
+          bot->hitScored(shooter->getName(), target, coord);
+          bot->updateSquares(shooter->getName(), shooter->getStatus(), { },
+                             shooter->getScore(), shooter->getSkips());
+        }
+        bot->updateSquares(target, targetBoard->getStatus(), squares,
+                           targetBoard->getScore(), targetBoard->getSkips());
+      }
+    }
+
+    if (!game.nextTurn()) {
+      break;
+    } else if (game.getTurnCount() > maxRounds) {
+      Logger::warn() << "Aborting game '" << game.getTitle() << "' after "
+                     << maxRounds << " rounds";
+      game.abort();
+      break;
+    }
+  }
+
+  const std::string state = game.isAborted() ? "aborted" : "finished";
+  for (Bot* bot : bots) {
+    bot->finishGame(state, game.getTurnCount(), game.getBoardCount());
+    for (auto& board : boards) {
+      bot->playerResult(board->getName(), board->getScore(),
+                        board->getSkips(), board->getTurns(),
+                        board->getStatus());
+    }
+  }
+
+  addResult(game);
+}
+
+//-----------------------------------------------------------------------------
+void Tournament::addResult(Game& game) {
+  const std::vector<BoardPtr> boards = game.getBoards();
+  unsigned highScore = 0;
+  for (auto& board : boards) {
+    highScore = std::max<unsigned>(highScore, board->getScore());
+  }
+
+  const unsigned first = std::count_if(boards.begin(), boards.end(),
+    [&](const BoardPtr& b) { return (b->getScore() == highScore); }
+  );
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (db) {
+    game.saveResults(*db);
+  }
+
+  played++;
+  aborted += game.isAborted();
+  for (auto& board : boards) {
+    Standing& standing = standings[board->getName()];
+    standing.games++;
+    standing.score += board->getScore();
+    standing.turns += board->getTurns();
+    standing.skips += board->getSkips();
+    if (board->getScore() == highScore) {
+      standing.wins += (first == 1);
+      standing.ties += (first > 1);
+    }
+  }
+
+  gameDone.notify_all();
+}
+
+//-----------------------------------------------------------------------------
+void Tournament::printProgress() {
+  timer.tick();
+  std::cout << played << " of " << gameCount << " games played, time "
+            << timer << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+void Tournament::printStandings() {
+  std::vector<std::pair<std::string, Standing>> table(standings.begin(),
+                                                      standings.end());
+  std::sort(table.begin(), table.end(),
+    [](const std::pair<std::string, Standing>& a,
+       const std::pair<std::string, Standing>& b)
+    {
+      return ((a.second.wins * 2) + a.second.ties) >
+             ((b.second.wins * 2) + b.second.ties);
+    }
+  );
+
+  std::cout << played << " games complete";
+  if (aborted) {
+    std::cout << " (" << aborted << " aborted)";
+  }
+  std::cout << ", time " << timer << std::endl << std::endl
+            << std::left << std::setw(20) << "Player"
+            << std::right << std::setw(8) << "Games"
+            << std::setw(8) << "Wins"
+            << std::setw(8) << "Ties"
+            << std::setw(10) << "Avg Score"
+            << std::setw(10) << "Avg Turns"
+            << std::setw(8) << "Skips" << std::endl;
+
+  for (auto& entry : table) {
+    const Standing& s = entry.second;
+    const double games = std::max<unsigned>(1, s.games);
+    std::cout << std::left << std::setw(20) << entry.first
+              << std::right << std::setw(8) << s.games
+              << std::setw(8) << s.wins
+              << std::setw(8) << s.ties
+              << std::setw(10) << std::fixed << std::setprecision(2)
+              << (s.score / games)
+              << std::setw(10) << (s.turns / games)
+              << std::setw(8) << s.skips << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+} // namespace xbs
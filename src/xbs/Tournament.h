@@ -0,0 +1,97 @@
+//-----------------------------------------------------------------------------
+// Tournament.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_TOURNAMENT_H
+#define XBS_TOURNAMENT_H
+
+#include "Platform.h"
+#include "Bot.h"
+#include "Configuration.h"
+#include "Game.h"
+#include "Timer.h"
+#include "db/Database.h"
+#include <condition_variable>
+#include <mutex>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// The Tournament class plays games between bots without a server.  The bots
+// are loaded as plugins and every game is played in-process with the same
+// shot and turn rules the server uses.  Games are played concurrently by
+// worker threads, each worker with its own instance of every bot, and the
+// results of every game are saved to the stats database.
+//-----------------------------------------------------------------------------
+class Tournament {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    DEFAULT_GAME_COUNT = 1000,
+    PROGRESS_INTERVAL = 5000 // milliseconds
+  };
+
+//-----------------------------------------------------------------------------
+private: // structs
+  struct Standing {
+    unsigned games = 0;
+    unsigned wins = 0;
+    unsigned ties = 0;
+    u_int64_t score = 0;
+    u_int64_t turns = 0;
+    u_int64_t skips = 0;
+  };
+
+//-----------------------------------------------------------------------------
+private: // variables
+  bool stopped = false;
+  unsigned gameCount = DEFAULT_GAME_COUNT;
+  unsigned workerCount = 1;
+  unsigned assigned = 0;
+  unsigned played = 0;
+  unsigned aborted = 0;
+  Configuration config;
+  std::unique_ptr<Database> db;
+  Timer timer;
+  std::string dbDir;
+  std::string dbLog;
+  std::vector<std::string> plugins;
+  std::map<std::string, Standing> standings;
+  std::mutex mutex;
+  std::condition_variable gameDone;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  Tournament() = default;
+  Tournament(Tournament&&) = delete;
+  Tournament(const Tournament&) = delete;
+  Tournament& operator=(Tournament&&) = delete;
+  Tournament& operator=(const Tournament&) = delete;
+
+//-----------------------------------------------------------------------------
+public: // methods
+  void showHelp();
+  bool init();
+  void run();
+
+  /**
+   * @brief Play all games with the given bots
+   * @param workers One set of bots for each worker thread, every set must
+   *        contain an instance of the same bots with the same player names
+   */
+  void run(const std::vector<std::vector<Bot*>>& workers);
+
+//-----------------------------------------------------------------------------
+private: // methods
+  bool nextGame();
+  void addResult(Game&);
+  void playGame(const std::vector<Bot*>& bots);
+  void printProgress();
+  void printStandings();
+  void runWorker(const std::vector<Bot*>& bots);
+};
+
+} // namespace xbs
+
+#endif // XBS_TOURNAMENT_H
@@ -0,0 +1,229 @@
+//-----------------------------------------------------------------------------
+// TraceReport.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "TraceReport.h"
+#include "CommandArgs.h"
+#include "Logger.h"
+#include "Ship.h"
+#include "StringUtils.h"
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+static std::string timeOfDay(const Microseconds usecs) {
+  const time_t secs = static_cast<time_t>(usecs / 1000000);
+  struct tm tmp;
+  char buf[32];
+  if (!localtime_r(&secs, &tmp) ||
+      !strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tmp))
+  {
+    buf[0] = 0;
+  }
+  std::stringstream ss;
+  ss << buf << '.' << std::setfill('0') << std::setw(6) << (usecs % 1000000);
+  return ss.str();
+}
+
+//-----------------------------------------------------------------------------
+static std::string toMillis(const Microseconds usecs) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3) << (usecs / 1000.0);
+  return ss.str();
+}
+
+//-----------------------------------------------------------------------------
+static std::string shotResult(const char id) {
+  if (!id) {
+    return "illegal";
+  } else if (Ship::isHit(id) || Ship::isMiss(id)) {
+    return "repeat";
+  } else if (Ship::isValidID(id)) {
+    return "hit";
+  }
+  return "miss";
+}
+
+//-----------------------------------------------------------------------------
+void TraceReport::showHelp() {
+  const std::string progname = CommandArgs::getInstance().getProgramName();
+  std::cout
+      << std::endl
+      << "usage: " << progname << " [OPTIONS] <trace-file>"
+      << std::endl << std::endl
+      << "GENERAL OPTIONS:" << std::endl
+      << "  --help                    Show help and exit" << std::endl
+      << "  -l, --log-level <level>   Set log level: DEBUG, INFO, WARN, ERROR "
+      << std::endl
+      << "  -f, --log-file <file>     Write log messages to given file"
+      << std::endl << std::endl
+      << "REPORT OPTIONS:" << std::endl
+      << "  -e, --events              Print events only, no latency stats"
+      << std::endl
+      << "  -s, --stats               Print latency stats only, no events"
+      << std::endl << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+bool TraceReport::init() {
+  const CommandArgs& args = CommandArgs::getInstance();
+  if (args.has("--help")) {
+    showHelp();
+    return false;
+  }
+
+  const int last = (args.getCount() - 1);
+  if ((last < 0) || args.isSwitch(last) ||
+      ((last > 0) && args.match((last - 1), {"-l", "--log-level",
+                                             "-f", "--log-file"})))
+  {
+    showHelp();
+    return false;
+  }
+
+  tracePath = args.get(last);
+  printEvents = !args.has({"-s", "--stats"});
+  printStats = !args.has({"-e", "--events"});
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool TraceReport::run() {
+  EventTraceReader reader;
+  reader.open(tracePath);
+
+  TraceEvent event;
+  std::string toMove;
+  Microseconds turnStart = 0;
+  latencies.clear();
+
+  while (reader.next(event)) {
+    if (printEvents) {
+      print(event);
+    }
+
+    switch (event.type) {
+    case TurnEvent:
+      toMove = event.player;
+      turnStart = event.time;
+      break;
+    case ShotEvent:
+      if ((event.player != toMove) || !event.result ||
+          Ship::isHit(event.result) || Ship::isMiss(event.result))
+      {
+        break;
+      }
+      // fall through
+    case SkipEvent:
+      if (event.player == toMove) {
+        latencies[toMove].push_back(event.time - turnStart);
+        toMove.clear();
+      }
+      break;
+    default:
+      toMove.clear();
+    }
+  }
+
+  if (reader.isTruncated()) {
+    Logger::printError() << tracePath << " ends with an incomplete event";
+  }
+  if (printStats) {
+    printLatencies();
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void TraceReport::print(const TraceEvent& event) {
+  std::cout << timeOfDay(event.time) << ' ';
+  switch (event.type) {
+  case SessionEvent:
+    std::cout << "SESSION";
+    break;
+  case PlayerNameEvent:
+    std::cout << "PLAYER " << event.player;
+    break;
+  case GameStartEvent:
+    std::cout << "START '" << event.text << "' " << event.x << 'x' << event.y
+              << ", " << event.count << " boards";
+    break;
+  case GameFinishEvent:
+    std::cout << "FINISH after " << event.count << " turns";
+    break;
+  case GameAbortEvent:
+    std::cout << "ABORT after " << event.count << " turns";
+    break;
+  case JoinEvent:
+    std::cout << "JOIN " << event.player << ' ' << event.text;
+    break;
+  case RejoinEvent:
+    std::cout << "REJOIN " << event.player;
+    break;
+  case LeaveEvent:
+    std::cout << "LEAVE " << event.player;
+    break;
+  case TurnEvent:
+    std::cout << "TURN " << event.player;
+    break;
+  case ShotEvent:
+    std::cout << "SHOT " << event.player << " -> " << event.target << ' '
+              << Coordinate(event.x, event.y) << ' ' << shotResult(event.result);
+    break;
+  case SkipEvent:
+    std::cout << "SKIP " << event.player;
+    break;
+  }
+  std::cout << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+void TraceReport::printLatencies() {
+  std::vector<Microseconds> all;
+  for (auto& entry : latencies) {
+    all.insert(all.end(), entry.second.begin(), entry.second.end());
+  }
+  if (all.empty()) {
+    std::cout << "No completed turns in " << tracePath << std::endl;
+    return;
+  }
+
+  std::cout << std::endl << "Turn latency (milliseconds):" << std::endl
+            << std::left << std::setw(20) << "Player"
+            << std::right << std::setw(8) << "Turns"
+            << std::setw(11) << "Min"
+            << std::setw(11) << "Mean"
+            << std::setw(11) << "Median"
+            << std::setw(11) << "P95"
+            << std::setw(11) << "Max" << std::endl;
+
+  auto printRow = [](const std::string& name, std::vector<Microseconds>& v) {
+    std::sort(v.begin(), v.end());
+    Microseconds total = 0;
+    for (const Microseconds usecs : v) {
+      total += usecs;
+    }
+    const size_t p95 = std::min<size_t>((v.size() - 1),
+                                        ((v.size() * 95) / 100));
+    std::cout << std::left << std::setw(20) << name
+              << std::right << std::setw(8) << v.size()
+              << std::setw(11) << toMillis(v.front())
+              << std::setw(11) << toMillis(total / Microseconds(v.size()))
+              << std::setw(11) << toMillis(v[v.size() / 2])
+              << std::setw(11) << toMillis(v[p95])
+              << std::setw(11) << toMillis(v.back()) << std::endl;
+  };
+
+  for (auto& entry : latencies) {
+    printRow(entry.first, entry.second);
+  }
+  if (latencies.size() > 1) {
+    printRow("(all)", all);
+  }
+}
+
+} // namespace xbs
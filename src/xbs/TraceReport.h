@@ -0,0 +1,50 @@
+//-----------------------------------------------------------------------------
+// TraceReport.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_TRACE_REPORT_H
+#define XBS_TRACE_REPORT_H
+
+#include "Platform.h"
+#include "EventTraceReader.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// The TraceReport class decodes an event trace written by the server.  It
+// prints every event in the trace, followed by turn latency statistics for
+// every player: the time from the start of a player's turn until the player
+// takes a legal shot or skips the turn.
+//-----------------------------------------------------------------------------
+class TraceReport {
+//-----------------------------------------------------------------------------
+private: // variables
+  bool printEvents = true;
+  bool printStats = true;
+  std::string tracePath;
+  std::map<std::string, std::vector<Microseconds>> latencies;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  TraceReport() = default;
+  TraceReport(TraceReport&&) = delete;
+  TraceReport(const TraceReport&) = delete;
+  TraceReport& operator=(TraceReport&&) = delete;
+  TraceReport& operator=(const TraceReport&) = delete;
+
+//-----------------------------------------------------------------------------
+public: // methods
+  void showHelp();
+  bool init();
+  bool run();
+
+//-----------------------------------------------------------------------------
+private: // methods
+  void print(const TraceEvent&);
+  void printLatencies();
+};
+
+} // namespace xbs
+
+#endif // XBS_TRACE_REPORT_H
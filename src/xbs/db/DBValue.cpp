@@ -0,0 +1,44 @@
+//-----------------------------------------------------------------------------
+// DBValue.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "DBValue.h"
+#include "StringUtils.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+int64_t DBValue::getInt() const noexcept {
+  switch (type) {
+  case StringType: return xbs::toInt64(str);
+  case BoolType:   return (num != 0);
+  default:         return static_cast<int64_t>(num);
+  }
+}
+
+//-----------------------------------------------------------------------------
+u_int64_t DBValue::getUInt() const noexcept {
+  switch (type) {
+  case StringType: return xbs::toUInt64(str);
+  case BoolType:   return (num != 0);
+  default:         return num;
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool DBValue::getBool() const noexcept {
+  return (type == StringType) ? xbs::toBool(str) : (num != 0);
+}
+
+//-----------------------------------------------------------------------------
+std::string DBValue::toString() const {
+  switch (type) {
+  case IntType:  return toStr(static_cast<int64_t>(num));
+  case UIntType: return toStr(num);
+  case BoolType: return toStr(num != 0);
+  default:       return str;
+  }
+}
+
+} // namespace xbs
@@ -0,0 +1,68 @@
+//-----------------------------------------------------------------------------
+// DBValue.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_DB_VALUE_H
+#define XBS_DB_VALUE_H
+
+#include "Platform.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// A single field value that keeps the type it was assigned with, so numeric
+// values can be read and updated without a round trip through a string.
+// Values of any type can be read as any other type, string values are
+// parsed when read as a number or bool.
+//-----------------------------------------------------------------------------
+class DBValue {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum Type {
+    StringType,
+    IntType,
+    UIntType,
+    BoolType
+  };
+
+//-----------------------------------------------------------------------------
+private: // variables
+  Type type = StringType;
+  u_int64_t num = 0;
+  std::string str;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  DBValue() = default;
+  DBValue(DBValue&&) = default;
+  DBValue(const DBValue&) = default;
+  DBValue& operator=(DBValue&&) = default;
+  DBValue& operator=(const DBValue&) = default;
+
+  explicit DBValue(const std::string& val) : type(StringType), str(val) { }
+  explicit DBValue(const char* val) : type(StringType), str(val ? val : "") { }
+  explicit DBValue(const int val) : type(IntType), num(int64_t(val)) { }
+  explicit DBValue(const int64_t val) : type(IntType), num(val) { }
+  explicit DBValue(const unsigned val) : type(UIntType), num(val) { }
+  explicit DBValue(const u_int64_t val) : type(UIntType), num(val) { }
+  explicit DBValue(const bool val) : type(BoolType), num(val) { }
+
+//-----------------------------------------------------------------------------
+public: // methods
+  Type getType() const noexcept { return type; }
+  int64_t getInt() const noexcept;
+  u_int64_t getUInt() const noexcept;
+  bool getBool() const noexcept;
+  std::string toString() const;
+
+  /**
+   * @brief Get the raw numeric value of a non-string value
+   * @return The value as stored, undefined for string values
+   */
+  u_int64_t getBits() const noexcept { return num; }
+};
+
+} // namespace xbs
+
+#endif // XBS_DB_VALUE_H
@@ -25,6 +25,13 @@ public: // abstract methods
   virtual std::vector<std::string> getRecordIDs() = 0;
   virtual std::shared_ptr<DBRecord> get(const std::string& recordID,
                                         const bool add) = 0;
+
+//-----------------------------------------------------------------------------
+public: // virtual methods
+  /**
+   * @brief Wait for writes started by sync() to complete
+   */
+  virtual void flush() noexcept { }
 };
 
 } // namespace xbs
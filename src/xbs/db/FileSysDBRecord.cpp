@@ -8,30 +8,21 @@
 #include "Msg.h"
 #include "StringUtils.h"
 #include "Error.h"
+#include <fcntl.h>
+#include <fstream>
 
 namespace xbs
 {
 
-//-----------------------------------------------------------------------------
-typedef std::vector<std::string> StringVector;
-typedef std::map<std::string, StringVector> FieldMap;
-
 //-----------------------------------------------------------------------------
 FileSysDBRecord::FileSysDBRecord(const std::string& recordID,
                                  const std::string& filePath)
   : recordID(recordID),
-    filePath(filePath),
-    dirty(false)
+    filePath(filePath)
 {
   load();
 }
 
-//-----------------------------------------------------------------------------
-void FileSysDBRecord::clear() {
-  fieldCache.clear();
-  dirty = true;
-}
-
 //-----------------------------------------------------------------------------
 void FileSysDBRecord::load() {
   if (recordID.empty()) {
@@ -44,10 +35,10 @@ void FileSysDBRecord::load() {
 
   std::ifstream file(filePath.c_str());
   if (!file) {
-    Logger::debug() << "File '" << filePath << "' does not exist";
+    XBS_LOG_DEBUG() << "File '" << filePath << "' does not exist";
     return;
   } else {
-    Logger::debug() << "Loading '" << filePath << "' as record ID '"
+    XBS_LOG_DEBUG() << "Loading '" << filePath << "' as record ID '"
                     << recordID << "'";
   }
 
@@ -71,13 +62,9 @@ void FileSysDBRecord::load() {
     }
 
     std::string val = (p != std::string::npos) ? trimStr(str.substr(p+1)) : "";
-    auto it = fieldCache.find(fld);
-    if (it == fieldCache.end()) {
-      it = fieldCache.insert(it, std::make_pair(fld, StringVector()));
-    }
-    it->second.push_back(val);
+    fields[fld].push_back(DBValue(val)); // parsed when read as a number
 
-    Logger::debug() << "Loaded " << filePath << '@' << line << ": '" << fld
+    XBS_LOG_DEBUG() << "Loaded " << filePath << '@' << line << ": '" << fld
                     << "'='" << val << "'";
   }
 }
@@ -85,120 +72,98 @@ void FileSysDBRecord::load() {
 //-----------------------------------------------------------------------------
 void FileSysDBRecord::store(const bool force) {
   if ((dirty | force) && recordID.size() && filePath.size()) {
-    std::ofstream file(filePath.c_str());
-    if (!file) {
-      throw Error(Msg() << "Failed to open '" << filePath << "': "
-                  << toError(errno));
-    }
-
-    for (auto it = fieldCache.begin(); it != fieldCache.end(); ++it) {
-      for (const auto& value : it->second) {
-        file << it->first << '=' << value << '\n';
-      }
-    }
-
-    if (!file.flush()) {
-      throw Error(Msg() << "flush(" << (*this) << ") failed: "
-                  << toError(errno));
-    }
+    writeFile(filePath, getContent());
   }
   dirty = false;
 }
 
 //-----------------------------------------------------------------------------
-void FileSysDBRecord::clear(const std::string& fieldName) {
-  const std::string fld = validate(fieldName);
-  auto it = fieldCache.find(fld);
-  if (it != fieldCache.end()) {
-    fieldCache.erase(it);
-    dirty = true;
-  }
-}
-
-//-----------------------------------------------------------------------------
-StringVector FileSysDBRecord::getStrings(const std::string& fieldName) const {
-  const std::string fld = validate(fieldName);
-  auto it = fieldCache.find(fld);
-  if (it != fieldCache.end()) {
-    return it->second;
-  }
-  return StringVector();
+std::string FileSysDBRecord::snapshot() {
+  dirty = false;
+  return getContent();
 }
 
 //-----------------------------------------------------------------------------
-std::string FileSysDBRecord::getString(const std::string& fieldName) const {
-  const std::string fld = validate(fieldName);
-  auto it = fieldCache.find(fld);
-  if ((it != fieldCache.end()) && (it->second.size())) {
-    return it->second.front();
+std::string FileSysDBRecord::getContent() const {
+  std::string content;
+  for (auto it = fields.begin(); it != fields.end(); ++it) {
+    for (const DBValue& value : it->second) {
+      content.append(it->first).append(1, '=').append(value.toString())
+          .append(1, '\n');
+    }
   }
-  return std::string();
+  return content;
 }
 
 //-----------------------------------------------------------------------------
-void FileSysDBRecord::setString(const std::string& fieldName,
-                                const std::string& val)
+void FileSysDBRecord::writeFile(const std::string& path,
+                                const std::string& content)
 {
-  const std::string fld = validate(fieldName, val);
-  auto it = fieldCache.find(fld);
-  if (it != fieldCache.end()) {
-    it->second.clear();
-  } else {
-    it = fieldCache.insert(fieldCache.end(),
-                           std::make_pair(fld, StringVector()));
+  if (path.empty()) {
+    throw Error("FileSysDBRecord.writeFile() empty path");
   }
-  it->second.push_back(val);
-  dirty = true;
-}
 
-//-----------------------------------------------------------------------------
-unsigned FileSysDBRecord::addString(const std::string& fieldName,
-                               const std::string& val)
-{
-  const std::string fld = validate(fieldName, val);
-  auto it = fieldCache.find(fld);
-  if (it == fieldCache.end()) {
-    it = fieldCache.insert(it, std::make_pair(fld, StringVector()));
+  // write a temp file and rename it over the original so readers never see
+  // a partially written record, even if the process dies mid-write
+  const std::string tmpPath = (path + ".tmp");
+  const int fd = ::open(tmpPath.c_str(), (O_WRONLY | O_CREAT | O_TRUNC), 0640);
+  if (fd < 0) {
+    throw Error(Msg() << "open(" << tmpPath << ") failed: " << toError(errno));
   }
-  it->second.push_back(val);
-  dirty = true;
-  return it->second.size();
-}
 
-//-----------------------------------------------------------------------------
-unsigned FileSysDBRecord::addStrings(const std::string& fieldName,
-                                     const StringVector& values)
-{
-  const std::string fld = validate(fieldName);
-  auto it = fieldCache.find(fld);
-  if (it == fieldCache.end()) {
-    it = fieldCache.insert(it, std::make_pair(fld, values));
-  } else {
-    for (const auto& value : values) {
-      if (contains(value, '\n')) {
-        throw Error("Newlines not supported in field values");
-      } else {
-        it->second.push_back(value);
+  const char* p = content.data();
+  size_t remain = content.size();
+  while (remain) {
+    const ssize_t n = ::write(fd, p, remain);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
       }
+      const int err = errno;
+      ::close(fd);
+      ::unlink(tmpPath.c_str());
+      throw Error(Msg() << "write(" << tmpPath << ") failed: "
+                  << toError(err));
     }
+    p += n;
+    remain -= n;
+  }
+
+  if (fsync(fd) != 0) {
+    const int err = errno;
+    ::close(fd);
+    ::unlink(tmpPath.c_str());
+    throw Error(Msg() << "fsync(" << tmpPath << ") failed: " << toError(err));
+  } else if (::close(fd) != 0) {
+    const int err = errno;
+    ::unlink(tmpPath.c_str());
+    throw Error(Msg() << "close(" << tmpPath << ") failed: " << toError(err));
+  }
+
+  if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+    const int err = errno;
+    ::unlink(tmpPath.c_str());
+    throw Error(Msg() << "rename(" << tmpPath << ", " << path << ") failed: "
+                << toError(err));
   }
-  dirty = true;
-  return it->second.size();
 }
 
 //-----------------------------------------------------------------------------
-std::string FileSysDBRecord::validate(const std::string& fieldName,
-                                      const std::string& val) const
-{
-  const std::string fld = trimStr(fieldName);
-  if (fld.empty()) {
-    throw Error("Empty field names not supported");
-  } else if (contains(fld, '\n')) {
+std::string FileSysDBRecord::validate(const std::string& fieldName) const {
+  const std::string fld = TypedDBRecord::validate(fieldName);
+  if (contains(fld, '\n')) {
     throw Error("Newlines not supported in field names");
-  } else if (contains(val, '\n')) {
-    throw Error("Newlines not supported in field values");
   }
   return fld;
 }
 
+//-----------------------------------------------------------------------------
+void FileSysDBRecord::validate(const DBValue& value) const {
+  if ((value.getType() == DBValue::StringType) &&
+      contains(value.toString(), '\n'))
+  {
+    throw Error("Newlines not supported in field values");
+  }
+}
+
 } // namespace xbs
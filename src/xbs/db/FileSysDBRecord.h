@@ -6,19 +6,21 @@
 #define XBS_FILESYSDBRECORD_H
 
 #include "Platform.h"
-#include "DBRecord.h"
+#include "TypedDBRecord.h"
 
 namespace xbs
 {
 
 //-----------------------------------------------------------------------------
-class FileSysDBRecord : public DBRecord {
+// A record stored as a text file with one field=value line per value.
+// Values loaded from the file are kept as strings until they are updated
+// as a number, numbers are only converted back to strings by store().
+//-----------------------------------------------------------------------------
+class FileSysDBRecord : public TypedDBRecord {
 //-----------------------------------------------------------------------------
 private: // variables
   std::string recordID;
   std::string filePath;
-  std::map<std::string, std::vector<std::string>> fieldCache;
-  bool dirty = false;
 
 //-----------------------------------------------------------------------------
 public: // constructors
@@ -33,25 +35,31 @@ public: // constructors
 //-----------------------------------------------------------------------------
 public: // DBRecord implementation
   std::string getID() const override { return recordID; }
-  std::string getString(const std::string& fld) const override;
-  std::vector<std::string> getStrings(const std::string& fld) const override;
-  void clear(const std::string& fld) override;
-  void setString(const std::string& fld, const std::string& val) override;
-  unsigned addString(const std::string& fld, const std::string& val) override;
-  unsigned addStrings(const std::string& fld,
-                      const std::vector<std::string>& values) override;
 
 //-----------------------------------------------------------------------------
 public: // methods
   std::string getFilePath() const { return filePath; }
-  void clear();
   void load();
   void store(const bool force = false);
 
+  /**
+   * @brief Get the file content of this record and mark it clean
+   * @return The content to pass to writeFile() when the record is stored
+   */
+  std::string snapshot();
+
+//-----------------------------------------------------------------------------
+public: // static methods
+  static void writeFile(const std::string& path, const std::string& content);
+
+//-----------------------------------------------------------------------------
+protected: // TypedDBRecord implementation
+  std::string validate(const std::string& fld) const override;
+  void validate(const DBValue&) const override;
+
 //-----------------------------------------------------------------------------
 private: // methods
-  std::string validate(const std::string& fld,
-                       const std::string& val = "") const;
+  std::string getContent() const;
 };
 
 } // namespace xbs
@@ -18,9 +18,11 @@ const std::string FileSysDatabase::DEFAULT_HOME_DIR = "./db";
 
 //-----------------------------------------------------------------------------
 void FileSysDatabase::close() noexcept {
+  flush();
   closeDir();
   try { homeDir.clear(); } catch (...) { ASSERT(false); }
   recordCache.clear();
+  lruList.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -57,7 +59,6 @@ FileSysDatabase& FileSysDatabase::open(const std::string& dbURI) {
   close();
   try {
     openDir(isEmpty(dbURI) ? DEFAULT_HOME_DIR : dbURI);
-    loadCache();
     closeDir();
   }
   catch (...) {
@@ -68,43 +69,69 @@ FileSysDatabase& FileSysDatabase::open(const std::string& dbURI) {
 }
 
 //-----------------------------------------------------------------------------
-void FileSysDatabase::loadCache() {
-  if (!dir) {
-    throw Error("FileSysDatabase.loadCache() dir not open");
-  }
-  for (dirent* entry = readdir(dir); entry; entry = readdir(dir)) {
-    std::string name = entry->d_name;
-    if ((name.size() > 4) && isalnum(name[0]) && iEndsWith(name, ".ini")) {
-      loadRecord(name.substr(0, (name.size() - 4)));
+std::string FileSysDatabase::getFilePath(const std::string& recordID) const {
+  return (homeDir + "/" + recordID + ".ini");
+}
+
+//-----------------------------------------------------------------------------
+void FileSysDatabase::setCacheLimit(const unsigned limit) {
+  cacheLimit = std::max<unsigned>(1, limit);
+  evict();
+}
+
+//-----------------------------------------------------------------------------
+void FileSysDatabase::evict() {
+  auto it = lruList.end();
+  while ((recordCache.size() > cacheLimit) && (it != lruList.begin())) {
+    auto entry = recordCache.find(*(--it));
+    ASSERT(entry != recordCache.end());
+    const auto& rec = entry->second.record;
+    if (rec && ((rec.use_count() > 1) || rec->isDirty())) {
+      continue; // still in use or not synced yet
     }
+    recordCache.erase(entry);
+    it = lruList.erase(it);
   }
 }
 
 //-----------------------------------------------------------------------------
-void FileSysDatabase::loadRecord(const std::string& recordID) {
-  std::string path = (homeDir + "/" + recordID + ".ini");
-  try {
-    recordCache[recordID] = std::make_shared<FileSysDBRecord>(recordID, path);
-  }
-  catch (const std::exception& e) {
-    Logger::error() << "Failed to load " << path << ": " << e.what();
-  }
-  catch (...) {
-    Logger::error() << "Failed to load " << path << ": unhandled exception";
+void FileSysDatabase::setFlushInterval(const Milliseconds interval) {
+  if (interval < 0) {
+    throw Error(Msg() << "Invalid " << (*this) << " flush interval: "
+                << interval);
   }
+  flush();
+  flushInterval = interval;
 }
 
 //-----------------------------------------------------------------------------
 void FileSysDatabase::sync() {
   try {
+    if (flushInterval <= 0) {
+      for (auto it = recordCache.begin(); it != recordCache.end(); ++it) {
+        auto rec = it->second.record;
+        if (rec) {
+          rec->store();
+        } else {
+          Logger::error() << "Null DB record for id '" << it->first << "'";
+        }
+      }
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(writeMutex);
     for (auto it = recordCache.begin(); it != recordCache.end(); ++it) {
-      auto rec = it->second;
-      if (rec) {
-        rec->store();
-      } else {
+      auto rec = it->second.record;
+      if (!rec) {
         Logger::error() << "Null DB record for id '" << it->first << "'";
+      } else if (rec->isDirty()) {
+        pendingWrites[rec->getFilePath()] = rec->snapshot();
       }
     }
+    if (pendingWrites.size()) {
+      startWriter();
+      writeReady.notify_one();
+    }
   }
   catch (const std::exception& e) {
     Logger::error() << "Failed to sync '" << homeDir << "' database: "
@@ -116,31 +143,111 @@ void FileSysDatabase::sync() {
 }
 
 //-----------------------------------------------------------------------------
-bool FileSysDatabase::remove(const std::string& recordID) {
-  bool ok = false;
-  auto it = recordCache.find(recordID);
-  if (it != recordCache.end()) {
+void FileSysDatabase::flush() noexcept {
+  if (writer.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(writeMutex);
+      stopping = true;
+      writeReady.notify_one();
+    }
+    writer.join();
+    stopping = false;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void FileSysDatabase::startWriter() {
+  if (!writer.joinable()) {
+    stopping = false;
+    writer = std::thread(&FileSysDatabase::writeLoop, this);
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool FileSysDatabase::takeWrite(const std::string& path,
+                                std::string& content)
+{
+  // wait for the writer to finish with this one file, if it has it, then
+  // take its queued content so the caller controls when it's written
+  std::unique_lock<std::mutex> lock(writeMutex);
+  writeDone.wait(lock, [&]() { return !inFlight.count(path); });
+  auto it = pendingWrites.find(path);
+  if (it == pendingWrites.end()) {
+    return false;
+  }
+  content.swap(it->second);
+  pendingWrites.erase(it);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void FileSysDatabase::writeLoop() noexcept {
+  std::unique_lock<std::mutex> lock(writeMutex);
+  while (true) {
+    writeReady.wait(lock, [this]() {
+      return (stopping || pendingWrites.size());
+    });
+    if (!stopping) {
+      // give more syncs of the same records a chance to coalesce
+      writeReady.wait_for(lock, std::chrono::milliseconds(flushInterval),
+                          [this]() { return stopping; });
+    }
+
+    inFlight.swap(pendingWrites);
+    const bool done = stopping;
+
+    lock.unlock();
+    writeFiles(inFlight);
+    lock.lock();
+
+    inFlight.clear();
+    writeDone.notify_all();
+
+    if (done && pendingWrites.empty()) {
+      break;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void FileSysDatabase::writeFiles(
+    const std::map<std::string, std::string>& files) noexcept
+{
+  for (auto it = files.begin(); it != files.end(); ++it) {
     try {
-      auto rec = it->second;
-      if (!rec) {
-        throw Error(Msg() << "Null " << (*this) << " record");
-      } else if (rec->getFilePath().empty()) {
-        throw Error(Msg() << "Empty " << (*rec) << " file path");
-      } else if (unlink(rec->getFilePath().c_str()) != 0) {
-        throw Error(Msg() << "unlink(" << rec->getFilePath() << ") failed: "
-                    << toError(errno));
-      }
-      ok = true;
+      FileSysDBRecord::writeFile(it->first, it->second);
     }
     catch (const std::exception& e) {
-      Logger::error() << "Failed to remove '" << homeDir << "/" << recordID
-                      << "': " << e.what();
+      Logger::error() << "Failed to write " << it->first << ": " << e.what();
     }
     catch (...) {
-      Logger::error() << "Failed to remove '" << homeDir << "/" << recordID
-                      << "'";
+      Logger::error() << "Failed to write " << it->first;
     }
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool FileSysDatabase::remove(const std::string& recordID) {
+  bool ok = false;
+  const std::string path = getFilePath(recordID);
+  std::string content;
+  if (writer.joinable()) {
+    takeWrite(path, content); // don't let a queued write re-create the file
+  }
+
+  auto it = recordCache.find(recordID);
+  if (it != recordCache.end()) {
+    lruList.erase(it->second.lru);
     recordCache.erase(it);
+    ok = true;
+  }
+
+  if (unlink(path.c_str()) == 0) {
+    ok = true;
+  } else if (errno != ENOENT) {
+    Logger::error() << "Failed to remove '" << path << "': "
+                    << toError(errno);
+    ok = false;
   }
   return ok;
 }
@@ -151,23 +258,50 @@ std::shared_ptr<DBRecord> FileSysDatabase::get(const std::string& recordID,
 {
   auto it = recordCache.find(recordID);
   if (it != recordCache.end()) {
-    return it->second;
-  } else if (add) {
-    std::string path = (homeDir + "/" + recordID + ".ini");
-    recordCache[recordID] = std::make_shared<FileSysDBRecord>(recordID, path);
-    return recordCache[recordID];
+    lruList.splice(lruList.begin(), lruList, it->second.lru);
+    return it->second.record;
+  }
+
+  // an evicted record may still have its last synced content queued
+  const std::string path = getFilePath(recordID);
+  std::string content;
+  if (writer.joinable() && takeWrite(path, content)) {
+    FileSysDBRecord::writeFile(path, content);
   }
-  return nullptr;
+
+  struct stat st;
+  if (!add && (stat(path.c_str(), &st) != 0)) {
+    return nullptr;
+  }
+
+  auto rec = std::make_shared<FileSysDBRecord>(recordID, path);
+  lruList.push_front(recordID);
+  CacheEntry& entry = recordCache[recordID];
+  entry.record = rec;
+  entry.lru = lruList.begin();
+  evict();
+  return rec;
 }
 
 //-----------------------------------------------------------------------------
 std::vector<std::string> FileSysDatabase::getRecordIDs() {
-  std::vector<std::string> recordIDs;
-  recordIDs.reserve(recordCache.size());
+  std::set<std::string> recordIDs;
   for (auto it = recordCache.begin(); it != recordCache.end(); ++it) {
-    recordIDs.push_back(it->first);
+    recordIDs.insert(it->first); // includes records that aren't stored yet
+  }
+
+  if (homeDir.size()) {
+    openDir(homeDir);
+    for (dirent* entry = readdir(dir); entry; entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if ((name.size() > 4) && isalnum(name[0]) && iEndsWith(name, ".ini")) {
+        recordIDs.insert(name.substr(0, (name.size() - 4)));
+      }
+    }
+    closeDir();
   }
-  return recordIDs;
+
+  return std::vector<std::string>(recordIDs.begin(), recordIDs.end());
 }
 
 } // namespace xbs
@@ -8,18 +8,56 @@
 #include "Platform.h"
 #include "Database.h"
 #include "FileSysDBRecord.h"
+#include "Timer.h"
+#include <condition_variable>
 #include <dirent.h>
+#include <list>
+#include <mutex>
+#include <thread>
 
 namespace xbs
 {
 
+//-----------------------------------------------------------------------------
+// Records are stored as one .ini file per record.  Records are loaded when
+// first requested and at most getCacheLimit() unused records are kept in
+// memory, the least recently used records are dropped first.
+//
+// By default sync() writes every dirty record before returning.  When a
+// flush interval is set sync() only takes a snapshot of the dirty records and
+// a background thread writes them after the interval has passed, so repeated
+// syncs of the same record within one interval are coalesced into a single
+// file write.
 //-----------------------------------------------------------------------------
 class FileSysDatabase : public Database {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    DEFAULT_CACHE_LIMIT = 1024
+  };
+
+//-----------------------------------------------------------------------------
+private: // structs
+  struct CacheEntry {
+    std::shared_ptr<FileSysDBRecord> record;
+    std::list<std::string>::iterator lru;
+  };
+
 //-----------------------------------------------------------------------------
 private: // variables
   DIR* dir = nullptr;
   std::string homeDir = DEFAULT_HOME_DIR;
-  std::map<std::string, std::shared_ptr<FileSysDBRecord>> recordCache;
+  unsigned cacheLimit = DEFAULT_CACHE_LIMIT;
+  std::map<std::string, CacheEntry> recordCache;
+  std::list<std::string> lruList; // most recently used record ID first
+  Milliseconds flushInterval = 0;
+  bool stopping = false;
+  std::map<std::string, std::string> pendingWrites; // file path -> content
+  std::map<std::string, std::string> inFlight; // being written by writer
+  std::mutex writeMutex;
+  std::condition_variable writeReady;
+  std::condition_variable writeDone;
+  std::thread writer;
 
 //-----------------------------------------------------------------------------
 public: // constructors
@@ -48,24 +86,44 @@ public: // Database implementation
   std::vector<std::string> getRecordIDs() override;
   std::shared_ptr<DBRecord> get(const std::string& recordID,
                                 const bool add) override;
+  void flush() noexcept override;
 
 //-----------------------------------------------------------------------------
 public: // methods
   void close() noexcept;
   FileSysDatabase& open(const std::string& dbHomeDir);
   std::string getHomeDir() const { return homeDir; }
+  Milliseconds getFlushInterval() const { return flushInterval; }
+  unsigned getCacheLimit() const { return cacheLimit; }
+
+  /**
+   * @brief Set how many records may be kept in memory
+   * Records that are dirty or still referenced outside the database are
+   * never dropped, so the cache may exceed this limit until they're not.
+   * @param limit The maximum number of cached records
+   */
+  void setCacheLimit(const unsigned limit);
+
+  /**
+   * @brief Set how long synced records may wait before they are written
+   * @param interval Milliseconds, 0 = write records during sync()
+   */
+  void setFlushInterval(const Milliseconds interval);
 
 //-----------------------------------------------------------------------------
 public: // operator overloads
   explicit operator bool() const noexcept { return homeDir.size(); }
 
-  //-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
 private: // methods
   void openDir(const std::string& path);
   void closeDir() noexcept;
-  void clearCache();
-  void loadCache();
-  void loadRecord(const std::string& recordID);
+  void evict();
+  std::string getFilePath(const std::string& recordID) const;
+  void startWriter();
+  bool takeWrite(const std::string& path, std::string& content);
+  void writeLoop() noexcept;
+  void writeFiles(const std::map<std::string, std::string>& files) noexcept;
 };
 
 } // namespace xbs
@@ -0,0 +1,21 @@
+//-----------------------------------------------------------------------------
+// LogDBRecord.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "LogDBRecord.h"
+#include "Error.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+LogDBRecord::LogDBRecord(const std::string& recordID, FieldMap&& fields)
+  : TypedDBRecord(std::move(fields)),
+    recordID(recordID)
+{
+  if (recordID.empty()) {
+    throw Error("Empty record ID");
+  }
+}
+
+} // namespace xbs
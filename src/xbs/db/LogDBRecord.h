@@ -0,0 +1,40 @@
+//-----------------------------------------------------------------------------
+// LogDBRecord.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_LOG_DB_RECORD_H
+#define XBS_LOG_DB_RECORD_H
+
+#include "Platform.h"
+#include "TypedDBRecord.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// A record of a LogDatabase.  The typed field values are encoded as-is when
+// the record is appended to the database log.
+//-----------------------------------------------------------------------------
+class LogDBRecord : public TypedDBRecord {
+//-----------------------------------------------------------------------------
+private: // variables
+  std::string recordID;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  LogDBRecord(LogDBRecord&&) = delete;
+  LogDBRecord(const LogDBRecord&) = delete;
+  LogDBRecord& operator=(LogDBRecord&&) = delete;
+  LogDBRecord& operator=(const LogDBRecord&) = delete;
+
+  explicit LogDBRecord(const std::string& recordID,
+                       FieldMap&& fields = FieldMap());
+
+//-----------------------------------------------------------------------------
+public: // DBRecord implementation
+  std::string getID() const override { return recordID; }
+};
+
+} // namespace xbs
+
+#endif // XBS_LOG_DB_RECORD_H
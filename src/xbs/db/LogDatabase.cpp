@@ -0,0 +1,520 @@
+//-----------------------------------------------------------------------------
+// LogDatabase.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "LogDatabase.h"
+#include "FileSysDBRecord.h"
+#include "Error.h"
+#include "Logger.h"
+#include "Msg.h"
+#include "StringUtils.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// log file layout:
+//   LOG_MAGIC
+//   entry*
+//
+// entry layout:
+//   u32 bodySize
+//   body: u8 kind, str recordID, [u32 fieldCount, field*]
+//   u32 checksum of body
+//
+// field layout:
+//   str name, u32 valueCount, value*
+//
+// value layout:
+//   u8 type, str value if type is StringType otherwise u64 value
+//
+// str layout:
+//   u32 length, char[length]
+//-----------------------------------------------------------------------------
+static const char LOG_MAGIC[8] = { 'X', 'B', 'S', 'L', 'O', 'G', '0', '1' };
+
+//-----------------------------------------------------------------------------
+enum EntryKind {
+  RecordEntry = 1,
+  RemovedEntry = 2
+};
+
+//-----------------------------------------------------------------------------
+static const u_int64_t ENTRY_OVERHEAD = (2 * sizeof(u_int32_t));
+
+//-----------------------------------------------------------------------------
+static u_int32_t checksum(const char* data, const u_int64_t size) noexcept {
+  u_int32_t hash = 2166136261U; // FNV-1a
+  for (u_int64_t i = 0; i < size; ++i) {
+    hash = ((hash ^ static_cast<unsigned char>(data[i])) * 16777619U);
+  }
+  return hash;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+static void put(std::string& buf, const T val) {
+  buf.append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+//-----------------------------------------------------------------------------
+static void putStr(std::string& buf, const std::string& str) {
+  put<u_int32_t>(buf, static_cast<u_int32_t>(str.size()));
+  buf.append(str);
+}
+
+//-----------------------------------------------------------------------------
+static u_int64_t beginEntry(std::string& buf, const EntryKind kind,
+                            const std::string& recordID)
+{
+  const u_int64_t start = buf.size();
+  put<u_int32_t>(buf, 0); // body size is set by endEntry()
+  put<u_int8_t>(buf, static_cast<u_int8_t>(kind));
+  putStr(buf, recordID);
+  return start;
+}
+
+//-----------------------------------------------------------------------------
+static u_int64_t endEntry(std::string& buf, const u_int64_t start) {
+  const u_int32_t bodySize = (buf.size() - start - sizeof(u_int32_t));
+  memcpy(&buf[start], &bodySize, sizeof(bodySize));
+  put<u_int32_t>(buf, checksum((buf.data() + start + sizeof(u_int32_t)),
+                               bodySize));
+  return (buf.size() - start);
+}
+
+//-----------------------------------------------------------------------------
+static u_int64_t putRecord(std::string& buf, const LogDBRecord& rec) {
+  const u_int64_t start = beginEntry(buf, RecordEntry, rec.getID());
+  put<u_int32_t>(buf, static_cast<u_int32_t>(rec.getFields().size()));
+  for (auto& field : rec.getFields()) {
+    putStr(buf, field.first);
+    put<u_int32_t>(buf, static_cast<u_int32_t>(field.second.size()));
+    for (const DBValue& value : field.second) {
+      put<u_int8_t>(buf, static_cast<u_int8_t>(value.getType()));
+      if (value.getType() == DBValue::StringType) {
+        putStr(buf, value.toString());
+      } else {
+        put<u_int64_t>(buf, value.getBits());
+      }
+    }
+  }
+  return endEntry(buf, start);
+}
+
+//-----------------------------------------------------------------------------
+static u_int64_t putRemoved(std::string& buf, const std::string& recordID) {
+  return endEntry(buf, beginEntry(buf, RemovedEntry, recordID));
+}
+
+//-----------------------------------------------------------------------------
+class LogReader {
+private:
+  const char* pos;
+  const char* end;
+
+public:
+  LogReader(const char* data, const u_int64_t size)
+    : pos(data),
+      end(data + size)
+  { }
+
+  template<typename T>
+  T get() {
+    T val;
+    need(sizeof(T));
+    memcpy(&val, pos, sizeof(T));
+    pos += sizeof(T);
+    return val;
+  }
+
+  std::string getStr() {
+    const u_int32_t len = get<u_int32_t>();
+    need(len);
+    std::string str(pos, len);
+    pos += len;
+    return str;
+  }
+
+private:
+  void need(const u_int64_t size) const {
+    if (size > u_int64_t(end - pos)) {
+      throw Error("Truncated log entry");
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+void LogDatabase::close() noexcept {
+  unmapLog();
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+  logSize = 0;
+  liveSize = 0;
+  try { logPath.clear(); } catch (...) { ASSERT(false); }
+  index.clear();
+  recordCache.clear();
+}
+
+//-----------------------------------------------------------------------------
+LogDatabase& LogDatabase::open(const std::string& logFilePath) {
+  close();
+  try {
+    if (isEmpty(logFilePath)) {
+      throw Error("LogDatabase.open() empty path");
+    }
+
+    fd = ::open(logFilePath.c_str(), (O_RDWR | O_CREAT | O_APPEND), 0640);
+    if (fd < 0) {
+      throw Error(Msg() << "open(" << logFilePath << ") failed: "
+                  << toError(errno));
+    }
+
+    logPath = logFilePath;
+    mapLog();
+    if (!logSize) {
+      append(std::string(LOG_MAGIC, sizeof(LOG_MAGIC)));
+    } else if ((logSize < sizeof(LOG_MAGIC)) ||
+               memcmp(map, LOG_MAGIC, sizeof(LOG_MAGIC)))
+    {
+      throw Error(Msg() << "'" << logFilePath << "' is not a log database");
+    } else {
+      scanLog();
+    }
+  }
+  catch (...) {
+    close();
+    throw;
+  }
+
+  XBS_LOG_DEBUG() << "Opened " << (*this) << " with " << index.size()
+                  << " records, " << liveSize << " of " << logSize
+                  << " bytes live";
+  return (*this);
+}
+
+//-----------------------------------------------------------------------------
+void LogDatabase::mapLog() {
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    throw Error(Msg() << "fstat(" << logPath << ") failed: "
+                << toError(errno));
+  }
+
+  logSize = st.st_size;
+  if (logSize) {
+    void* addr = mmap(nullptr, logSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+      throw Error(Msg() << "mmap(" << logPath << ") failed: "
+                  << toError(errno));
+    }
+    map = static_cast<const char*>(addr);
+    mapSize = logSize;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LogDatabase::unmapLog() noexcept {
+  if (map) {
+    munmap(const_cast<char*>(map), mapSize);
+    map = nullptr;
+    mapSize = 0;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LogDatabase::scanLog() {
+  u_int64_t offset = sizeof(LOG_MAGIC);
+  while (offset < mapSize) {
+    u_int32_t bodySize = 0;
+    if ((mapSize - offset) < ENTRY_OVERHEAD) {
+      break;
+    }
+
+    memcpy(&bodySize, (map + offset), sizeof(bodySize));
+    if (bodySize > (mapSize - offset - ENTRY_OVERHEAD)) {
+      break;
+    }
+
+    // an entry that fits in the file but fails its checksum is corruption,
+    // not an interrupted write, don't throw away the entries after it
+    u_int32_t sum = 0;
+    const char* body = (map + offset + sizeof(u_int32_t));
+    memcpy(&sum, (body + bodySize), sizeof(sum));
+    if (sum != checksum(body, bodySize)) {
+      throw Error(Msg() << logPath << " checksum mismatch at offset "
+                  << offset);
+    }
+
+    LogReader reader(body, bodySize);
+    const u_int8_t kind = reader.get<u_int8_t>();
+    const std::string recordID = reader.getStr();
+    if (kind == RecordEntry) {
+      IndexEntry entry;
+      entry.offset = offset;
+      entry.size = (bodySize + ENTRY_OVERHEAD);
+      setIndex(recordID, entry);
+    } else if (kind == RemovedEntry) {
+      auto it = index.find(recordID);
+      if (it != index.end()) {
+        liveSize -= it->second.size;
+        index.erase(it);
+      }
+    } else {
+      throw Error(Msg() << logPath << " unknown entry type ("
+                  << static_cast<unsigned>(kind) << ") at offset " << offset);
+    }
+    offset += (bodySize + ENTRY_OVERHEAD);
+  }
+
+  if (offset < logSize) {
+    // the tail of the log was not completely written, most likely because
+    // the process died during sync(), discard it so new entries can follow
+    Logger::warn() << "Discarding " << (logSize - offset) << " bytes of "
+                   << "incomplete entries at the end of " << (*this);
+    if (ftruncate(fd, offset) != 0) {
+      throw Error(Msg() << "ftruncate(" << logPath << ") failed: "
+                  << toError(errno));
+    }
+    logSize = offset;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LogDatabase::setIndex(const std::string& recordID,
+                           const IndexEntry& entry)
+{
+  IndexEntry& current = index[recordID];
+  liveSize -= current.size;
+  liveSize += entry.size;
+  current = entry;
+}
+
+//-----------------------------------------------------------------------------
+void LogDatabase::append(const std::string& entries) {
+  const char* p = entries.data();
+  u_int64_t remain = entries.size();
+  while (remain) {
+    const ssize_t n = ::write(fd, p, remain);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      const int err = errno;
+      if (ftruncate(fd, logSize) != 0) { // don't leave a partial entry
+        Logger::error() << "ftruncate(" << logPath << ") failed: "
+                        << toError(errno);
+      }
+      throw Error(Msg() << "write(" << logPath << ") failed: "
+                  << toError(err));
+    }
+    p += n;
+    remain -= n;
+  }
+
+  if (fdatasync(fd) != 0) {
+    const int err = errno;
+    if (ftruncate(fd, logSize) != 0) { // keep logSize in step with the file
+      Logger::error() << "ftruncate(" << logPath << ") failed: "
+                      << toError(errno);
+    }
+    throw Error(Msg() << "fdatasync(" << logPath << ") failed: "
+                << toError(err));
+  }
+  logSize += entries.size();
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<LogDBRecord> LogDatabase::loadRecord(
+    const std::string& recordID,
+    const IndexEntry& entry)
+{
+  if ((entry.offset + entry.size) > mapSize) {
+    // entry was appended after the log was mapped
+    unmapLog();
+    mapLog();
+  }
+
+  const char* body = (map + entry.offset + sizeof(u_int32_t));
+  LogReader reader(body, (entry.size - ENTRY_OVERHEAD));
+  if ((reader.get<u_int8_t>() != RecordEntry) ||
+      (reader.getStr() != recordID))
+  {
+    throw Error(Msg() << "Invalid " << (*this) << " index entry for '"
+                << recordID << "'");
+  }
+
+  LogDBRecord::FieldMap fields;
+  const u_int32_t fieldCount = reader.get<u_int32_t>();
+  for (u_int32_t i = 0; i < fieldCount; ++i) {
+    std::vector<DBValue>& values = fields[reader.getStr()];
+    const u_int32_t valueCount = reader.get<u_int32_t>();
+    values.reserve(valueCount);
+    for (u_int32_t n = 0; n < valueCount; ++n) {
+      const u_int8_t type = reader.get<u_int8_t>();
+      switch (type) {
+      case DBValue::StringType:
+        values.push_back(DBValue(reader.getStr()));
+        break;
+      case DBValue::IntType:
+        values.push_back(DBValue(static_cast<int64_t>(
+            reader.get<u_int64_t>())));
+        break;
+      case DBValue::UIntType:
+        values.push_back(DBValue(reader.get<u_int64_t>()));
+        break;
+      case DBValue::BoolType:
+        values.push_back(DBValue(reader.get<u_int64_t>() != 0));
+        break;
+      default:
+        throw Error(Msg() << "Invalid value type (" << unsigned(type)
+                    << ") in " << (*this) << " record '" << recordID << "'");
+      }
+    }
+  }
+
+  return std::make_shared<LogDBRecord>(recordID, std::move(fields));
+}
+
+//-----------------------------------------------------------------------------
+void LogDatabase::sync() {
+  try {
+    std::string entries;
+    std::vector<std::pair<std::shared_ptr<LogDBRecord>, IndexEntry>> synced;
+    for (auto it = recordCache.begin(); it != recordCache.end(); ++it) {
+      auto rec = it->second;
+      if (!rec) {
+        Logger::error() << "Null DB record for id '" << it->first << "'";
+      } else if (rec->isDirty()) {
+        IndexEntry entry;
+        entry.offset = (logSize + entries.size());
+        entry.size = putRecord(entries, (*rec));
+        synced.push_back(std::make_pair(rec, entry));
+      }
+    }
+
+    if (entries.size()) {
+      append(entries);
+      for (auto& pair : synced) {
+        setIndex(pair.first->getID(), pair.second);
+        pair.first->setDirty(false);
+      }
+    }
+
+    if ((logSize >= COMPACT_MIN_SIZE) && (liveSize < (logSize / 2))) {
+      compact();
+    }
+  }
+  catch (const std::exception& e) {
+    Logger::error() << "Failed to sync '" << logPath << "' database: "
+                    << e.what();
+  }
+  catch (...) {
+    Logger::error() << "Failed to sync '" << logPath << "' database";
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LogDatabase::compact() {
+  if (fd < 0) {
+    throw Error("LogDatabase.compact() log not open");
+  }
+
+  // make sure every indexed entry is mapped
+  unmapLog();
+  mapLog();
+
+  std::string log(LOG_MAGIC, sizeof(LOG_MAGIC));
+  std::map<std::string, IndexEntry> newIndex;
+  log.reserve(log.size() + liveSize);
+  for (auto& pair : index) {
+    IndexEntry& entry = newIndex[pair.first];
+    entry.offset = log.size();
+    entry.size = pair.second.size;
+    log.append((map + pair.second.offset), pair.second.size);
+  }
+
+  const u_int64_t oldSize = logSize;
+  FileSysDBRecord::writeFile(logPath, log);
+
+  unmapLog();
+  ::close(fd);
+  fd = ::open(logPath.c_str(), (O_RDWR | O_APPEND), 0640);
+  if (fd < 0) {
+    const std::string path = logPath;
+    close();
+    throw Error(Msg() << "open(" << path << ") failed: " << toError(errno));
+  }
+
+  mapLog();
+  index.swap(newIndex);
+
+  Logger::info() << "Compacted " << (*this) << " from " << oldSize << " to "
+                 << logSize << " bytes";
+}
+
+//-----------------------------------------------------------------------------
+bool LogDatabase::remove(const std::string& recordID) {
+  auto it = index.find(recordID);
+  if (it == index.end()) {
+    return recordCache.erase(recordID);
+  }
+
+  // the record stays indexed unless its tombstone is safely in the log
+  try {
+    std::string entry;
+    putRemoved(entry, recordID);
+    append(entry);
+  }
+  catch (const std::exception& e) {
+    Logger::error() << "Failed to remove '" << recordID << "' from "
+                    << (*this) << ": " << e.what();
+    return false;
+  }
+
+  liveSize -= it->second.size;
+  index.erase(it);
+  recordCache.erase(recordID);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<DBRecord> LogDatabase::get(const std::string& recordID,
+                                           const bool add)
+{
+  auto it = recordCache.find(recordID);
+  if (it != recordCache.end()) {
+    return it->second;
+  }
+
+  auto entry = index.find(recordID);
+  if (entry != index.end()) {
+    return (recordCache[recordID] = loadRecord(recordID, entry->second));
+  } else if (add) {
+    return (recordCache[recordID] = std::make_shared<LogDBRecord>(recordID));
+  }
+  return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<std::string> LogDatabase::getRecordIDs() {
+  std::vector<std::string> recordIDs;
+  recordIDs.reserve(index.size());
+  for (auto it = index.begin(); it != index.end(); ++it) {
+    recordIDs.push_back(it->first);
+  }
+  for (auto it = recordCache.begin(); it != recordCache.end(); ++it) {
+    if (!index.count(it->first)) {
+      recordIDs.push_back(it->first);
+    }
+  }
+  return recordIDs;
+}
+
+} // namespace xbs
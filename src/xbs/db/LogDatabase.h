@@ -0,0 +1,109 @@
+//-----------------------------------------------------------------------------
+// LogDatabase.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_LOG_DATABASE_H
+#define XBS_LOG_DATABASE_H
+
+#include "Platform.h"
+#include "Database.h"
+#include "LogDBRecord.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// All records are stored in a single append-only log file.  sync() appends
+// one entry per dirty record with all of the record's typed field values,
+// and remove() appends a tombstone entry, so a later entry for the same
+// record ID supersedes every earlier one.
+//
+// open() memory-maps the log and only scans the entry headers to build an
+// index of the latest entry of each record.  Records are decoded from the
+// map the first time they're requested.  When superseded entries make up
+// most of the log it is compacted: the live entries are copied to a new log
+// file which then replaces the old one.
+//
+// An entry cut short at the end of the log, by a crash during sync(), is
+// discarded by open().  A damaged entry anywhere else makes open() fail
+// rather than lose the entries that follow it.
+//
+// Entries are written in host byte order, log files are not portable
+// between hosts of different endianness.
+//-----------------------------------------------------------------------------
+class LogDatabase : public Database {
+//-----------------------------------------------------------------------------
+public: // enums
+  enum {
+    COMPACT_MIN_SIZE = (1024 * 1024) // bytes
+  };
+
+//-----------------------------------------------------------------------------
+private: // structs
+  struct IndexEntry {
+    u_int64_t offset = 0;
+    u_int64_t size = 0;
+  };
+
+//-----------------------------------------------------------------------------
+private: // variables
+  int fd = -1;
+  const char* map = nullptr;
+  u_int64_t mapSize = 0;
+  u_int64_t logSize = 0;
+  u_int64_t liveSize = 0;
+  std::string logPath;
+  std::map<std::string, IndexEntry> index;
+  std::map<std::string, std::shared_ptr<LogDBRecord>> recordCache;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  LogDatabase() = default;
+  LogDatabase(LogDatabase&&) = delete;
+  LogDatabase(const LogDatabase&) = delete;
+  LogDatabase& operator=(LogDatabase&&) = delete;
+  LogDatabase& operator=(const LogDatabase&) = delete;
+
+//-----------------------------------------------------------------------------
+public: // destructor
+  virtual ~LogDatabase() noexcept { close(); }
+
+//-----------------------------------------------------------------------------
+public: // Database::Printable implementation
+  std::string toString() const override { return logPath; }
+
+//-----------------------------------------------------------------------------
+public: // Database implementation
+  void sync() override;
+  bool remove(const std::string& recordID) override;
+  std::vector<std::string> getRecordIDs() override;
+  std::shared_ptr<DBRecord> get(const std::string& recordID,
+                                const bool add) override;
+
+//-----------------------------------------------------------------------------
+public: // methods
+  void close() noexcept;
+  void compact();
+  LogDatabase& open(const std::string& logFilePath);
+  std::string getLogPath() const { return logPath; }
+  u_int64_t getLogSize() const noexcept { return logSize; }
+  u_int64_t getLiveSize() const noexcept { return liveSize; }
+
+//-----------------------------------------------------------------------------
+public: // operator overloads
+  explicit operator bool() const noexcept { return (fd >= 0); }
+
+//-----------------------------------------------------------------------------
+private: // methods
+  void append(const std::string& entries);
+  void mapLog();
+  void unmapLog() noexcept;
+  void scanLog();
+  void setIndex(const std::string& recordID, const IndexEntry&);
+  std::shared_ptr<LogDBRecord> loadRecord(const std::string& recordID,
+                                          const IndexEntry&);
+};
+
+} // namespace xbs
+
+#endif // XBS_LOG_DATABASE_H
@@ -0,0 +1,285 @@
+//-----------------------------------------------------------------------------
+// TypedDBRecord.cpp
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#include "TypedDBRecord.h"
+#include "Error.h"
+#include "StringUtils.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+template<typename T> T valueAs(const DBValue&);
+
+template<> int valueAs<int>(const DBValue& value) {
+  return static_cast<int>(value.getInt());
+}
+
+template<> unsigned valueAs<unsigned>(const DBValue& value) {
+  return static_cast<unsigned>(value.getUInt());
+}
+
+template<> u_int64_t valueAs<u_int64_t>(const DBValue& value) {
+  return value.getUInt();
+}
+
+template<> bool valueAs<bool>(const DBValue& value) {
+  return value.getBool();
+}
+
+template<> std::string valueAs<std::string>(const DBValue& value) {
+  return value.toString();
+}
+
+//-----------------------------------------------------------------------------
+void TypedDBRecord::clear() {
+  fields.clear();
+  dirty = true;
+}
+
+//-----------------------------------------------------------------------------
+void TypedDBRecord::clear(const std::string& fieldName) {
+  auto it = fields.find(validate(fieldName));
+  if (it != fields.end()) {
+    fields.erase(it);
+    dirty = true;
+  }
+}
+
+//-----------------------------------------------------------------------------
+std::string TypedDBRecord::validate(const std::string& fieldName) const {
+  const std::string fld = trimStr(fieldName);
+  if (fld.empty()) {
+    throw Error("Empty field names not supported");
+  }
+  return fld;
+}
+
+//-----------------------------------------------------------------------------
+const DBValue* TypedDBRecord::first(const std::string& fieldName) const {
+  auto it = fields.find(validate(fieldName));
+  if ((it != fields.end()) && it->second.size()) {
+    return &(it->second.front());
+  }
+  return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+std::vector<T> TypedDBRecord::getValues(const std::string& fieldName) const {
+  std::vector<T> values;
+  auto it = fields.find(validate(fieldName));
+  if (it != fields.end()) {
+    values.reserve(it->second.size());
+    for (const DBValue& value : it->second) {
+      values.push_back(valueAs<T>(value));
+    }
+  }
+  return values;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+T TypedDBRecord::getValue(const std::string& fieldName) const {
+  const DBValue* value = first(fieldName);
+  return value ? valueAs<T>(*value) : T();
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+T TypedDBRecord::incValue(const std::string& fieldName, const T inc) {
+  std::vector<DBValue>& values = fields[validate(fieldName)];
+  if (values.empty()) {
+    values.push_back(DBValue(inc));
+  } else {
+    values.resize(1);
+    values.front() = DBValue(static_cast<T>(valueAs<T>(values.front()) + inc));
+  }
+  dirty = true;
+  return valueAs<T>(values.front());
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+void TypedDBRecord::setValue(const std::string& fieldName, const T& val) {
+  DBValue value(val);
+  validate(value);
+  std::vector<DBValue>& values = fields[validate(fieldName)];
+  values.clear();
+  values.push_back(std::move(value));
+  dirty = true;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+unsigned TypedDBRecord::addValues(const std::string& fieldName,
+                                  const std::vector<T>& newValues)
+{
+  std::vector<DBValue>& values = fields[validate(fieldName)];
+  values.reserve(values.size() + newValues.size());
+  for (const T& val : newValues) {
+    DBValue value(val);
+    validate(value);
+    values.push_back(std::move(value));
+  }
+  dirty = true;
+  return values.size();
+}
+
+//-----------------------------------------------------------------------------
+std::vector<std::string> TypedDBRecord::getStrings(const std::string& fld)
+const {
+  return getValues<std::string>(fld);
+}
+
+//-----------------------------------------------------------------------------
+std::string TypedDBRecord::getString(const std::string& fld) const {
+  return getValue<std::string>(fld);
+}
+
+//-----------------------------------------------------------------------------
+void TypedDBRecord::setString(const std::string& fld, const std::string& val) {
+  setValue(fld, val);
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::addString(const std::string& fld,
+                                  const std::string& val)
+{
+  return addValues(fld, std::vector<std::string> { val });
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::addStrings(const std::string& fld,
+                                   const std::vector<std::string>& values)
+{
+  return addValues(fld, values);
+}
+
+//-----------------------------------------------------------------------------
+std::vector<int> TypedDBRecord::getInts(const std::string& fld) const {
+  return getValues<int>(fld);
+}
+
+//-----------------------------------------------------------------------------
+int TypedDBRecord::getInt(const std::string& fld) const {
+  return getValue<int>(fld);
+}
+
+//-----------------------------------------------------------------------------
+int TypedDBRecord::incInt(const std::string& fld, const int inc) {
+  return incValue(fld, inc);
+}
+
+//-----------------------------------------------------------------------------
+void TypedDBRecord::setInt(const std::string& fld, const int val) {
+  setValue(fld, val);
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::addInt(const std::string& fld, const int val) {
+  return addValues(fld, std::vector<int> { val });
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::addInts(const std::string& fld,
+                                const std::vector<int>& values)
+{
+  return addValues(fld, values);
+}
+
+//-----------------------------------------------------------------------------
+std::vector<unsigned> TypedDBRecord::getUInts(const std::string& fld) const {
+  return getValues<unsigned>(fld);
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::getUInt(const std::string& fld) const {
+  return getValue<unsigned>(fld);
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::incUInt(const std::string& fld, const unsigned inc) {
+  return incValue(fld, inc);
+}
+
+//-----------------------------------------------------------------------------
+void TypedDBRecord::setUInt(const std::string& fld, const unsigned val) {
+  setValue(fld, val);
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::addUInt(const std::string& fld, const unsigned val) {
+  return addValues(fld, std::vector<unsigned> { val });
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::addUInts(const std::string& fld,
+                                 const std::vector<unsigned>& values)
+{
+  return addValues(fld, values);
+}
+
+//-----------------------------------------------------------------------------
+std::vector<u_int64_t> TypedDBRecord::getUInt64s(const std::string& fld) const {
+  return getValues<u_int64_t>(fld);
+}
+
+//-----------------------------------------------------------------------------
+u_int64_t TypedDBRecord::getUInt64(const std::string& fld) const {
+  return getValue<u_int64_t>(fld);
+}
+
+//-----------------------------------------------------------------------------
+u_int64_t TypedDBRecord::incUInt64(const std::string& fld,
+                                   const u_int64_t inc)
+{
+  return incValue(fld, inc);
+}
+
+//-----------------------------------------------------------------------------
+void TypedDBRecord::setUInt64(const std::string& fld, const u_int64_t val) {
+  setValue(fld, val);
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::addUInt64(const std::string& fld, const u_int64_t val) {
+  return addValues(fld, std::vector<u_int64_t> { val });
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::addUInt64s(const std::string& fld,
+                                   const std::vector<u_int64_t>& values)
+{
+  return addValues(fld, values);
+}
+
+//-----------------------------------------------------------------------------
+std::vector<bool> TypedDBRecord::getBools(const std::string& fld) const {
+  return getValues<bool>(fld);
+}
+
+//-----------------------------------------------------------------------------
+bool TypedDBRecord::getBool(const std::string& fld) const {
+  return getValue<bool>(fld);
+}
+
+//-----------------------------------------------------------------------------
+void TypedDBRecord::setBool(const std::string& fld, const bool val) {
+  setValue(fld, val);
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::addBool(const std::string& fld, const bool val) {
+  return addValues(fld, std::vector<bool> { val });
+}
+
+//-----------------------------------------------------------------------------
+unsigned TypedDBRecord::addBools(const std::string& fld,
+                                 const std::vector<bool>& values)
+{
+  return addValues(fld, values);
+}
+
+} // namespace xbs
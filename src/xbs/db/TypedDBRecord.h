@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+// TypedDBRecord.h
+// Copyright (c) 2017 Shawn Chidester, All rights reserved
+//-----------------------------------------------------------------------------
+#ifndef XBS_TYPED_DB_RECORD_H
+#define XBS_TYPED_DB_RECORD_H
+
+#include "Platform.h"
+#include "DBRecord.h"
+#include "DBValue.h"
+
+namespace xbs
+{
+
+//-----------------------------------------------------------------------------
+// Base class for records that keep field values as typed DBValues.  Numeric
+// fields are updated in place, values are only converted to strings when
+// they are read as strings or when the record is stored.
+//-----------------------------------------------------------------------------
+class TypedDBRecord : public DBRecord {
+//-----------------------------------------------------------------------------
+public: // typedefs
+  typedef std::map<std::string, std::vector<DBValue>> FieldMap;
+
+//-----------------------------------------------------------------------------
+protected: // variables
+  FieldMap fields;
+  bool dirty = false;
+
+//-----------------------------------------------------------------------------
+public: // constructors
+  TypedDBRecord(TypedDBRecord&&) = delete;
+  TypedDBRecord(const TypedDBRecord&) = delete;
+  TypedDBRecord& operator=(TypedDBRecord&&) = delete;
+  TypedDBRecord& operator=(const TypedDBRecord&) = delete;
+
+  explicit TypedDBRecord(FieldMap&& fields = FieldMap())
+    : fields(std::move(fields))
+  { }
+
+//-----------------------------------------------------------------------------
+public: // DBRecord implementation
+  std::string getString(const std::string& fld) const override;
+  std::vector<std::string> getStrings(const std::string& fld) const override;
+  void clear(const std::string& fld) override;
+  void setString(const std::string& fld, const std::string& val) override;
+  unsigned addString(const std::string& fld, const std::string& val) override;
+  unsigned addStrings(const std::string& fld,
+                      const std::vector<std::string>& values) override;
+
+  std::vector<int> getInts(const std::string& fld) const override;
+  int getInt(const std::string& fld) const override;
+  int incInt(const std::string& fld, const int inc = 1) override;
+  void setInt(const std::string& fld, const int val) override;
+  unsigned addInt(const std::string& fld, const int val) override;
+  unsigned addInts(const std::string& fld,
+                   const std::vector<int>& values) override;
+
+  std::vector<unsigned> getUInts(const std::string& fld) const override;
+  unsigned getUInt(const std::string& fld) const override;
+  unsigned incUInt(const std::string& fld, const unsigned inc = 1) override;
+  void setUInt(const std::string& fld, const unsigned val) override;
+  unsigned addUInt(const std::string& fld, const unsigned val) override;
+  unsigned addUInts(const std::string& fld,
+                    const std::vector<unsigned>& values) override;
+
+  std::vector<u_int64_t> getUInt64s(const std::string& fld) const override;
+  u_int64_t getUInt64(const std::string& fld) const override;
+  u_int64_t incUInt64(const std::string& fld,
+                      const u_int64_t inc = 1) override;
+  void setUInt64(const std::string& fld, const u_int64_t val) override;
+  unsigned addUInt64(const std::string& fld, const u_int64_t val) override;
+  unsigned addUInt64s(const std::string& fld,
+                      const std::vector<u_int64_t>& values) override;
+
+  std::vector<bool> getBools(const std::string& fld) const override;
+  bool getBool(const std::string& fld) const override;
+  void setBool(const std::string& fld, const bool val) override;
+  unsigned addBool(const std::string& fld, const bool val) override;
+  unsigned addBools(const std::string& fld,
+                    const std::vector<bool>& values) override;
+
+//-----------------------------------------------------------------------------
+public: // methods
+  const FieldMap& getFields() const noexcept { return fields; }
+  bool isDirty() const noexcept { return dirty; }
+  void setDirty(const bool value) noexcept { dirty = value; }
+  void clear();
+
+//-----------------------------------------------------------------------------
+protected: // virtual methods
+  virtual std::string validate(const std::string& fld) const;
+  virtual void validate(const DBValue&) const { }
+
+//-----------------------------------------------------------------------------
+private: // methods
+  const DBValue* first(const std::string& fld) const;
+
+  template<typename T>
+  std::vector<T> getValues(const std::string& fld) const;
+
+  template<typename T>
+  T getValue(const std::string& fld) const;
+
+  template<typename T>
+  T incValue(const std::string& fld, const T inc);
+
+  template<typename T>
+  void setValue(const std::string& fld, const T& val);
+
+  template<typename T>
+  unsigned addValues(const std::string& fld, const std::vector<T>& values);
+};
+
+} // namespace xbs
+
+#endif // XBS_TYPED_DB_RECORD_H